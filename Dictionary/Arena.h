@@ -0,0 +1,116 @@
+#ifndef DICTIONARY_ARENA_H
+#define DICTIONARY_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+/**
+ * @brief Classe che rappresenta un'arena: la memoria viene prelevata in sequenza da
+ * grandi blocchi e non viene mai restituita singolarmente, ma tutta insieme con
+ * svuota() o alla distruzione dell'arena.
+ * Un'allocazione costa l'avanzamento di un puntatore; i blocchi sono allocati
+ * raramente e una richiesta più grande di un blocco riceve un blocco dedicato.
+ * <br>
+ * La memoria delle tabelle abbandonate durante la crescita di un dizionario resta
+ * occupata fino al rilascio dell'arena: l'arena conviene per molti dizionari con
+ * la stessa durata, oppure per dizionari dimensionati in anticipo con reserve().
+ * I dizionari devono essere distrutti prima di svuotare o distruggere l'arena.
+ */
+class Arena {
+public:
+    static const size_t DIM_BLOCCO = size_t(1) << 20;
+
+    explicit Arena(size_t dimBlocco = DIM_BLOCCO)
+            : ultimo(nullptr), cima(nullptr), limite(nullptr), dimBlocco(dimBlocco), totale(0) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena() {svuota();}
+
+    void* preleva(size_t, size_t);
+    void svuota();
+    size_t occupati() const {return totale;}
+
+private:
+    struct Blocco {
+        Blocco* precedente;
+    };
+
+    Blocco* ultimo;         // blocco corrente, in testa alla lista dei blocchi
+    char* cima;             // primo byte libero del blocco corrente
+    char* limite;           // fine del blocco corrente
+    size_t dimBlocco;
+    size_t totale;          // byte ottenuti dal sistema, per tutti i blocchi
+};
+/**
+ * @brief Metodo che preleva dim byte allineati ad allineamento.
+ * @param dim numero di byte.
+ * @param allineamento allineamento richiesto, potenza di 2.
+ * @return puntatore alla memoria prelevata.
+ */
+inline void* Arena::preleva(size_t dim, size_t allineamento) {
+    size_t scarto = (allineamento - reinterpret_cast<uintptr_t>(cima) % allineamento) % allineamento;
+    size_t libero = static_cast<size_t>(limite - cima);
+    if (cima == nullptr || scarto > libero || dim > libero - scarto) {
+        size_t necessari = sizeof(Blocco) + dim + allineamento;
+        if (necessari < dim)
+            throw std::bad_alloc();
+        size_t nuovaDim = necessari > dimBlocco ? necessari : dimBlocco;
+        Blocco* b = static_cast<Blocco*>(::operator new(nuovaDim));
+        b->precedente = ultimo;
+        ultimo = b;
+        cima = reinterpret_cast<char*>(b + 1);
+        limite = reinterpret_cast<char*>(b) + nuovaDim;
+        totale += nuovaDim;
+        scarto = (allineamento - reinterpret_cast<uintptr_t>(cima) % allineamento) % allineamento;
+    }
+    char* p = cima + scarto;
+    cima = p + dim;
+    return p;
+}
+/**
+ * @brief Metodo che rilascia tutti i blocchi dell'arena in una volta.
+ */
+inline void Arena::svuota() {
+    while (ultimo != nullptr) {
+        Blocco* precedente = ultimo->precedente;
+        ::operator delete(ultimo);
+        ultimo = precedente;
+    }
+    cima = nullptr;
+    limite = nullptr;
+    totale = 0;
+}
+
+/**
+ * @brief Allocatore che preleva la memoria da un'Arena; deallocate() non fa nulla.
+ * Tutte le copie di un allocatore, anche per tipi diversi, usano la stessa arena.
+ * @tparam T tipo degli oggetti allocati.
+ */
+template <class T>
+class AllocatoreArena {
+public:
+    typedef T value_type;
+
+    explicit AllocatoreArena(Arena& arena) : arena(&arena) {}
+    template <class U>
+    AllocatoreArena(const AllocatoreArena<U>& a) : arena(a.arena) {}
+
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T))
+            throw std::bad_alloc();
+        return static_cast<T*>(arena->preleva(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) {}
+
+    template <class U>
+    bool operator==(const AllocatoreArena<U>& a) const {return arena == a.arena;}
+    template <class U>
+    bool operator!=(const AllocatoreArena<U>& a) const {return arena != a.arena;}
+
+private:
+    template <class U> friend class AllocatoreArena;
+    Arena* arena;
+};
+
+#endif //DICTIONARY_ARENA_H
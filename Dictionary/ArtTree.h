@@ -0,0 +1,1067 @@
+#ifndef DICTIONARY_ARTTREE_H
+#define DICTIONARY_ARTTREE_H
+
+#include "Dictionary.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARTTREE_SSE2
+#endif
+
+/**
+ * @brief Classe che rappresenta un dizionario con chiavi stringa basato su un
+ * Adaptive Radix Tree (ART).
+ * Ogni nodo interno consuma un byte della chiave e, secondo il numero di figli,
+ * assume una di quattro forme: Nodo4 e Nodo16 (byte ordinati e figli affiancati,
+ * Nodo16 confrontato con una sola istruzione SSE2 dove disponibile), Nodo48 (indice
+ * di 256 byte verso 48 figli) e Nodo256 (un figlio per byte). I nodi crescono e si
+ * riducono passando da una forma all'altra.
+ * <br>
+ * I tratti di chiave comuni a tutte le chiavi di un sottoalbero sono memorizzati una
+ * sola volta, come prefisso del nodo (compressione dei cammini); una foglia contiene
+ * l'elemento e la sola parte della chiave che nessun'altra chiave condivide. Le
+ * chiavi non vengono quindi memorizzate per intero: keys() e le visite le
+ * ricostruiscono lungo il cammino. Una chiave che termina in un nodo interno,
+ * perché prefisso di altre chiavi, è associata al nodo stesso.
+ * <br>
+ * Ricerca, inserimento e cancellazione costano O(lunghezza della chiave),
+ * indipendentemente dal numero di chiavi. Le visite con perOgni() e
+ * perOgniConPrefisso() procedono in ordine lessicografico dei byte.
+ * @tparam E tipo dell'elemento.
+ */
+template <class E>
+class ArtTree : public Dictionary<std::string, E> {
+public:
+    typedef typename Dictionary<std::string, E>::Key Key;
+    typedef typename Dictionary<std::string, E>::Element Element;
+
+    ArtTree() : radice(nullptr), numCoppie(0) {}
+    ArtTree(const ArtTree& t) : radice(copia(t.radice)), numCoppie(t.numCoppie) {}
+    ~ArtTree() {distruggi(radice);}
+
+    bool dizionarioVuoto() const {return numCoppie == 0;}
+    void inserisci(const Couple<Key,Element>&);
+    void inserisci(Couple<Key,Element>&&);
+    void cancella(const Key&);
+    Element recupera(const Key&) const;
+    bool appartiene(const Key& key) const {return cerca(key) != nullptr;}
+    void aggiorna(const Key&, const Element&);
+
+    Element* find(const Key&);
+    const Element* find(const Key&) const;
+    bool tryGet(const Key&, Element&) const;
+
+    template<class... Args>
+    std::pair<Element*, bool> try_emplace(const Key&, Args&&...);
+    template<class E1>
+    std::pair<Element*, bool> insert_or_assign(const Key&, E1&&);
+
+    template<class F>
+    void perOgni(F) const;
+    template<class F>
+    void perOgniConPrefisso(const Key&, F) const;
+
+    void clear();
+    int lunghezza() const {return numCoppie;}
+    size_t memoria() const {return memoriaDi(radice);}
+    VectorList<Key> keys() const;
+    VectorList<E> values() const;
+
+    ArtTree<E>& operator=(const ArtTree<E>&);
+    bool operator==(const ArtTree<E>&) const;
+    bool operator!=(const ArtTree<E>&) const;
+
+    template<class E1>
+    friend std::ostream& operator<<(std::ostream&, const ArtTree<E1>&);
+
+private:
+    static const uint8_t NODO4 = 0;
+    static const uint8_t NODO16 = 1;
+    static const uint8_t NODO48 = 2;
+    static const uint8_t NODO256 = 3;
+
+    struct Foglia;
+
+    /**
+     * @brief Intestazione comune ai nodi interni; il prefisso segue in memoria il
+     * nodo concreto.
+     */
+    struct Nodo {
+        explicit Nodo(uint8_t tipo) : tipo(tipo), numFigli(0), lunghezzaPrefisso(0), valore(nullptr) {}
+
+        uint8_t tipo;
+        uint16_t numFigli;
+        uint32_t lunghezzaPrefisso;
+        Foglia* valore;             // chiave che termina in questo nodo, nullptr se assente
+    };
+    struct Nodo4 : Nodo {
+        Nodo4() : Nodo(NODO4), chiavi(), figli() {}
+        unsigned char chiavi[4];    // ordinate
+        Nodo* figli[4];
+    };
+    struct Nodo16 : Nodo {
+        Nodo16() : Nodo(NODO16), chiavi(), figli() {}
+        unsigned char chiavi[16];   // ordinate
+        Nodo* figli[16];
+    };
+    struct Nodo48 : Nodo {
+        Nodo48() : Nodo(NODO48), indice(), figli() {}
+        unsigned char indice[256];  // posizione in figli + 1, 0 se il byte non ha figlio
+        Nodo* figli[48];
+    };
+    struct Nodo256 : Nodo {
+        Nodo256() : Nodo(NODO256), figli() {}
+        Nodo* figli[256];
+    };
+
+    /**
+     * @brief Foglia: elemento e parte finale della chiave, che la segue in memoria.
+     * I puntatori alle foglie tra i figli di un nodo hanno il bit meno significativo a 1.
+     */
+    struct Foglia {
+        template<class... Args>
+        explicit Foglia(uint32_t lunghezza, Args&&... args) : elemento(std::forward<Args>(args)...), lunghezza(lunghezza) {}
+        unsigned char* suffisso() {return reinterpret_cast<unsigned char*>(this + 1);}
+        const unsigned char* suffisso() const {return reinterpret_cast<const unsigned char*>(this + 1);}
+
+        E elemento;
+        uint32_t lunghezza;
+    };
+
+    static bool eFoglia(const Nodo* n) {return (reinterpret_cast<uintptr_t>(n) & 1) != 0;}
+    static Foglia* comeFoglia(const Nodo* n) {return reinterpret_cast<Foglia*>(reinterpret_cast<uintptr_t>(n) & ~uintptr_t(1));}
+    static Nodo* etichetta(Foglia* f) {return reinterpret_cast<Nodo*>(reinterpret_cast<uintptr_t>(f) | 1);}
+    static size_t dimensione(uint8_t);
+    static unsigned char* prefisso(Nodo* n) {return reinterpret_cast<unsigned char*>(n) + dimensione(n->tipo);}
+    static const unsigned char* prefisso(const Nodo* n) {return reinterpret_cast<const unsigned char*>(n) + dimensione(n->tipo);}
+    static size_t comune(const unsigned char*, size_t, const unsigned char*, size_t);
+
+    static Nodo* nuovoNodo(uint8_t, const unsigned char*, size_t);
+    static Nodo* ricopia(const Nodo*, const unsigned char*, size_t);
+    template<class... Args>
+    static Foglia* nuovaFoglia(const unsigned char*, size_t, Args&&...);
+    static void distruggiFoglia(Foglia*);
+    static void distruggi(Nodo*);
+    static Nodo* copia(const Nodo*);
+    static size_t memoriaDi(const Nodo*);
+
+    template<class F>
+    static void perOgniFiglio(const Nodo*, F);
+    static Nodo** trovaFiglio(Nodo*, unsigned char);
+    static void aggiungiFiglio(Nodo**, unsigned char, Nodo*);
+    static void rimuoviFiglio(Nodo**, unsigned char);
+    static void cresci(Nodo**);
+    static void riduci(Nodo**);
+    static void compatta(Nodo**);
+
+    Foglia* cerca(std::string_view) const;
+    template<class... Args>
+    std::pair<Foglia*, bool> inserisciSeAssente(std::string_view, Args&&...);
+    bool cancellaIn(Nodo**, std::string_view, size_t);
+    template<class F>
+    static void visita(const Nodo*, std::string&, F&);
+
+    Nodo* radice;       // nullptr se il dizionario è vuoto; può essere una foglia
+    int numCoppie;
+};
+/**
+ * @brief Metodo che restituisce la dimensione in byte di un nodo del tipo indicato,
+ * prefisso escluso.
+ * @tparam E tipo dell'elemento.
+ * @param tipo tipo del nodo.
+ * @return dimensione del nodo.
+ */
+template <class E>
+size_t ArtTree<E>::dimensione(uint8_t tipo) {
+    switch (tipo) {
+        case NODO4: return sizeof(Nodo4);
+        case NODO16: return sizeof(Nodo16);
+        case NODO48: return sizeof(Nodo48);
+        default: return sizeof(Nodo256);
+    }
+}
+/**
+ * @brief Metodo che calcola la lunghezza del tratto iniziale comune a due sequenze di byte.
+ * @tparam E tipo dell'elemento.
+ * @param a prima sequenza.
+ * @param na lunghezza di a.
+ * @param b seconda sequenza.
+ * @param nb lunghezza di b.
+ * @return numero di byte iniziali uguali.
+ */
+template <class E>
+size_t ArtTree<E>::comune(const unsigned char* a, size_t na, const unsigned char* b, size_t nb) {
+    size_t n = na < nb ? na : nb;
+    size_t i = 0;
+    while (i < n && a[i] == b[i])
+        i++;
+    return i;
+}
+/**
+ * @brief Metodo che alloca un nodo vuoto del tipo indicato con il prefisso indicato.
+ * @tparam E tipo dell'elemento.
+ * @param tipo tipo del nodo.
+ * @param p prefisso.
+ * @param lunghezza lunghezza del prefisso.
+ * @return nodo allocato.
+ */
+template <class E>
+typename ArtTree<E>::Nodo* ArtTree<E>::nuovoNodo(uint8_t tipo, const unsigned char* p, size_t lunghezza) {
+    void* memoria = ::operator new(dimensione(tipo) + lunghezza);
+    Nodo* n;
+    switch (tipo) {
+        case NODO4: n = new (memoria) Nodo4(); break;
+        case NODO16: n = new (memoria) Nodo16(); break;
+        case NODO48: n = new (memoria) Nodo48(); break;
+        default: n = new (memoria) Nodo256(); break;
+    }
+    n->lunghezzaPrefisso = static_cast<uint32_t>(lunghezza);
+    std::memcpy(prefisso(n), p, lunghezza);
+    return n;
+}
+/**
+ * @brief Metodo che alloca una copia del nodo n, con gli stessi figli e lo stesso
+ * valore ma con il prefisso indicato.
+ * @tparam E tipo dell'elemento.
+ * @param n nodo da copiare.
+ * @param p nuovo prefisso.
+ * @param lunghezza lunghezza del nuovo prefisso.
+ * @return copia del nodo.
+ */
+template <class E>
+typename ArtTree<E>::Nodo* ArtTree<E>::ricopia(const Nodo* n, const unsigned char* p, size_t lunghezza) {
+    void* memoria = ::operator new(dimensione(n->tipo) + lunghezza);
+    Nodo* c;
+    switch (n->tipo) {
+        case NODO4: c = new (memoria) Nodo4(*static_cast<const Nodo4*>(n)); break;
+        case NODO16: c = new (memoria) Nodo16(*static_cast<const Nodo16*>(n)); break;
+        case NODO48: c = new (memoria) Nodo48(*static_cast<const Nodo48*>(n)); break;
+        default: c = new (memoria) Nodo256(*static_cast<const Nodo256*>(n)); break;
+    }
+    c->lunghezzaPrefisso = static_cast<uint32_t>(lunghezza);
+    std::memcpy(prefisso(c), p, lunghezza);
+    return c;
+}
+/**
+ * @brief Metodo che alloca una foglia con il suffisso indicato e l'elemento costruito da args.
+ * @tparam E tipo dell'elemento.
+ * @param s suffisso della chiave.
+ * @param lunghezza lunghezza del suffisso.
+ * @param args argomenti del costruttore dell'elemento.
+ * @return foglia allocata.
+ */
+template <class E>
+template <class... Args>
+typename ArtTree<E>::Foglia* ArtTree<E>::nuovaFoglia(const unsigned char* s, size_t lunghezza, Args&&... args) {
+    void* memoria = ::operator new(sizeof(Foglia) + lunghezza);
+    Foglia* f;
+    try {
+        f = new (memoria) Foglia(static_cast<uint32_t>(lunghezza), std::forward<Args>(args)...);
+    } catch (...) {
+        ::operator delete(memoria);
+        throw;
+    }
+    if (lunghezza != 0)
+        std::memcpy(f->suffisso(), s, lunghezza);
+    return f;
+}
+/**
+ * @brief Metodo che distrugge una foglia e ne rilascia la memoria.
+ * @tparam E tipo dell'elemento.
+ * @param f foglia da distruggere.
+ */
+template <class E>
+void ArtTree<E>::distruggiFoglia(Foglia* f) {
+    f->~Foglia();
+    ::operator delete(f);
+}
+/**
+ * @brief Metodo che distrugge il sottoalbero di radice n.
+ * @tparam E tipo dell'elemento.
+ * @param n radice del sottoalbero, eventualmente una foglia o nullptr.
+ */
+template <class E>
+void ArtTree<E>::distruggi(Nodo* n) {
+    if (n == nullptr)
+        return;
+    if (eFoglia(n)) {
+        distruggiFoglia(comeFoglia(n));
+        return;
+    }
+    perOgniFiglio(n, [](unsigned char, Nodo* figlio) {distruggi(figlio);});
+    if (n->valore != nullptr)
+        distruggiFoglia(n->valore);
+    ::operator delete(n);
+}
+/**
+ * @brief Metodo che copia il sottoalbero di radice n.
+ * @tparam E tipo dell'elemento.
+ * @param n radice del sottoalbero, eventualmente una foglia o nullptr.
+ * @return radice della copia.
+ */
+template <class E>
+typename ArtTree<E>::Nodo* ArtTree<E>::copia(const Nodo* n) {
+    if (n == nullptr)
+        return nullptr;
+    if (eFoglia(n)) {
+        const Foglia* f = comeFoglia(n);
+        return etichetta(nuovaFoglia(f->suffisso(), f->lunghezza, f->elemento));
+    }
+    Nodo* c = ricopia(n, prefisso(n), n->lunghezzaPrefisso);
+    if (n->valore != nullptr)
+        c->valore = nuovaFoglia(nullptr, 0, n->valore->elemento);
+    perOgniFiglio(c, [c](unsigned char b, Nodo* figlio) {*trovaFiglio(c, b) = copia(figlio);});
+    return c;
+}
+/**
+ * @brief Metodo che calcola la memoria occupata dai nodi e dalle foglie del
+ * sottoalbero di radice n.
+ * @tparam E tipo dell'elemento.
+ * @param n radice del sottoalbero, eventualmente una foglia o nullptr.
+ * @return numero di byte allocati.
+ */
+template <class E>
+size_t ArtTree<E>::memoriaDi(const Nodo* n) {
+    if (n == nullptr)
+        return 0;
+    if (eFoglia(n))
+        return sizeof(Foglia) + comeFoglia(n)->lunghezza;
+    size_t totale = dimensione(n->tipo) + n->lunghezzaPrefisso;
+    if (n->valore != nullptr)
+        totale += sizeof(Foglia);
+    perOgniFiglio(n, [&totale](unsigned char, Nodo* figlio) {totale += memoriaDi(figlio);});
+    return totale;
+}
+/**
+ * @brief Metodo che applica f a ogni figlio del nodo n, in ordine crescente di byte.
+ * @tparam E tipo dell'elemento.
+ * @tparam F funzione con parametri (unsigned char byte, Nodo* figlio).
+ * @param n nodo interno.
+ * @param f funzione da applicare.
+ */
+template <class E>
+template <class F>
+void ArtTree<E>::perOgniFiglio(const Nodo* n, F f) {
+    switch (n->tipo) {
+        case NODO4: {
+            const Nodo4* x = static_cast<const Nodo4*>(n);
+            for (int i = 0; i < x->numFigli; i++)
+                f(x->chiavi[i], x->figli[i]);
+            break;
+        }
+        case NODO16: {
+            const Nodo16* x = static_cast<const Nodo16*>(n);
+            for (int i = 0; i < x->numFigli; i++)
+                f(x->chiavi[i], x->figli[i]);
+            break;
+        }
+        case NODO48: {
+            const Nodo48* x = static_cast<const Nodo48*>(n);
+            for (int b = 0; b < 256; b++) {
+                if (x->indice[b] != 0)
+                    f(static_cast<unsigned char>(b), x->figli[x->indice[b] - 1]);
+            }
+            break;
+        }
+        default: {
+            const Nodo256* x = static_cast<const Nodo256*>(n);
+            for (int b = 0; b < 256; b++) {
+                if (x->figli[b] != nullptr)
+                    f(static_cast<unsigned char>(b), x->figli[b]);
+            }
+            break;
+        }
+    }
+}
+/**
+ * @brief Metodo che cerca il figlio del nodo n associato al byte b.
+ * @tparam E tipo dell'elemento.
+ * @param n nodo interno.
+ * @param b byte della chiave.
+ * @return puntatore alla posizione del figlio, nullptr se il figlio non esiste.
+ */
+template <class E>
+typename ArtTree<E>::Nodo** ArtTree<E>::trovaFiglio(Nodo* n, unsigned char b) {
+    switch (n->tipo) {
+        case NODO4: {
+            Nodo4* x = static_cast<Nodo4*>(n);
+            for (int i = 0; i < x->numFigli; i++) {
+                if (x->chiavi[i] == b)
+                    return &x->figli[i];
+            }
+            return nullptr;
+        }
+        case NODO16: {
+            Nodo16* x = static_cast<Nodo16*>(n);
+#if defined(ARTTREE_SSE2)
+            __m128i uguali = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(b)),
+                                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(x->chiavi)));
+            unsigned maschera = static_cast<unsigned>(_mm_movemask_epi8(uguali)) & ((1u << x->numFigli) - 1);
+            if (maschera == 0)
+                return nullptr;
+            int i = 0;
+            while ((maschera & 1u) == 0) {
+                maschera >>= 1;
+                i++;
+            }
+            return &x->figli[i];
+#else
+            for (int i = 0; i < x->numFigli; i++) {
+                if (x->chiavi[i] == b)
+                    return &x->figli[i];
+            }
+            return nullptr;
+#endif
+        }
+        case NODO48: {
+            Nodo48* x = static_cast<Nodo48*>(n);
+            return x->indice[b] != 0 ? &x->figli[x->indice[b] - 1] : nullptr;
+        }
+        default: {
+            Nodo256* x = static_cast<Nodo256*>(n);
+            return x->figli[b] != nullptr ? &x->figli[b] : nullptr;
+        }
+    }
+}
+/**
+ * @brief Metodo che aggiunge al nodo *rif il figlio associato al byte b, passando
+ * prima alla forma più grande se il nodo è pieno.
+ * @tparam E tipo dell'elemento.
+ * @param rif posizione del nodo interno, aggiornata se il nodo cambia forma.
+ * @param b byte della chiave, senza figlio nel nodo.
+ * @param figlio figlio da aggiungere.
+ */
+template <class E>
+void ArtTree<E>::aggiungiFiglio(Nodo** rif, unsigned char b, Nodo* figlio) {
+    Nodo* n = *rif;
+    if ((n->tipo == NODO4 && n->numFigli == 4) || (n->tipo == NODO16 && n->numFigli == 16)
+        || (n->tipo == NODO48 && n->numFigli == 48)) {
+        cresci(rif);
+        n = *rif;
+    }
+    switch (n->tipo) {
+        case NODO4:
+        case NODO16: {
+            unsigned char* chiavi = n->tipo == NODO4 ? static_cast<Nodo4*>(n)->chiavi : static_cast<Nodo16*>(n)->chiavi;
+            Nodo** figli = n->tipo == NODO4 ? static_cast<Nodo4*>(n)->figli : static_cast<Nodo16*>(n)->figli;
+            int i = n->numFigli;
+            while (i > 0 && chiavi[i - 1] > b) {
+                chiavi[i] = chiavi[i - 1];
+                figli[i] = figli[i - 1];
+                i--;
+            }
+            chiavi[i] = b;
+            figli[i] = figlio;
+            break;
+        }
+        case NODO48: {
+            Nodo48* x = static_cast<Nodo48*>(n);
+            int i = 0;
+            while (x->figli[i] != nullptr)
+                i++;
+            x->figli[i] = figlio;
+            x->indice[b] = static_cast<unsigned char>(i + 1);
+            break;
+        }
+        default:
+            static_cast<Nodo256*>(n)->figli[b] = figlio;
+            break;
+    }
+    n->numFigli++;
+}
+/**
+ * @brief Metodo che rimuove dal nodo *rif il figlio associato al byte b, passando
+ * alla forma più piccola se i figli rimasti sono pochi.
+ * @tparam E tipo dell'elemento.
+ * @param rif posizione del nodo interno, aggiornata se il nodo cambia forma.
+ * @param b byte della chiave del figlio da rimuovere.
+ */
+template <class E>
+void ArtTree<E>::rimuoviFiglio(Nodo** rif, unsigned char b) {
+    Nodo* n = *rif;
+    switch (n->tipo) {
+        case NODO4:
+        case NODO16: {
+            unsigned char* chiavi = n->tipo == NODO4 ? static_cast<Nodo4*>(n)->chiavi : static_cast<Nodo16*>(n)->chiavi;
+            Nodo** figli = n->tipo == NODO4 ? static_cast<Nodo4*>(n)->figli : static_cast<Nodo16*>(n)->figli;
+            int i = 0;
+            while (chiavi[i] != b)
+                i++;
+            for (; i < n->numFigli - 1; i++) {
+                chiavi[i] = chiavi[i + 1];
+                figli[i] = figli[i + 1];
+            }
+            break;
+        }
+        case NODO48: {
+            Nodo48* x = static_cast<Nodo48*>(n);
+            x->figli[x->indice[b] - 1] = nullptr;
+            x->indice[b] = 0;
+            break;
+        }
+        default:
+            static_cast<Nodo256*>(n)->figli[b] = nullptr;
+            break;
+    }
+    n->numFigli--;
+    if ((n->tipo == NODO16 && n->numFigli <= 3) || (n->tipo == NODO48 && n->numFigli <= 12)
+        || (n->tipo == NODO256 && n->numFigli <= 37))
+        riduci(rif);
+}
+/**
+ * @brief Metodo che sostituisce il nodo pieno *rif con uno della forma successiva.
+ * @tparam E tipo dell'elemento.
+ * @param rif posizione del nodo interno.
+ */
+template <class E>
+void ArtTree<E>::cresci(Nodo** rif) {
+    Nodo* n = *rif;
+    Nodo* c = nuovoNodo(static_cast<uint8_t>(n->tipo + 1), prefisso(n), n->lunghezzaPrefisso);
+    c->valore = n->valore;
+    perOgniFiglio(n, [&c](unsigned char b, Nodo* figlio) {aggiungiFiglio(&c, b, figlio);});
+    ::operator delete(n);
+    *rif = c;
+}
+/**
+ * @brief Metodo che sostituisce il nodo *rif con uno della forma precedente.
+ * @tparam E tipo dell'elemento.
+ * @param rif posizione del nodo interno.
+ */
+template <class E>
+void ArtTree<E>::riduci(Nodo** rif) {
+    Nodo* n = *rif;
+    Nodo* c = nuovoNodo(static_cast<uint8_t>(n->tipo - 1), prefisso(n), n->lunghezzaPrefisso);
+    c->valore = n->valore;
+    perOgniFiglio(n, [&c](unsigned char b, Nodo* figlio) {aggiungiFiglio(&c, b, figlio);});
+    ::operator delete(n);
+    *rif = c;
+}
+/**
+ * @brief Metodo che ripristina la compressione del nodo *rif dopo una cancellazione:
+ * un nodo senza figli diventa una foglia, o scompare se non ha valore; un nodo
+ * senza valore con un solo figlio si fonde con esso.
+ * @tparam E tipo dell'elemento.
+ * @param rif posizione del nodo interno.
+ */
+template <class E>
+void ArtTree<E>::compatta(Nodo** rif) {
+    Nodo* n = *rif;
+    if (n->numFigli == 0) {
+        if (n->valore != nullptr) {
+            Foglia* f = nuovaFoglia(prefisso(n), n->lunghezzaPrefisso, std::move(n->valore->elemento));
+            distruggiFoglia(n->valore);
+            *rif = etichetta(f);
+        } else {
+            *rif = nullptr;
+        }
+        ::operator delete(n);
+        return;
+    }
+    if (n->numFigli != 1 || n->valore != nullptr)
+        return;
+
+    unsigned char b = 0;
+    Nodo* figlio = nullptr;
+    perOgniFiglio(n, [&b, &figlio](unsigned char c, Nodo* f) {
+        b = c;
+        figlio = f;
+    });
+    std::string unito(reinterpret_cast<const char*>(prefisso(n)), n->lunghezzaPrefisso);
+    unito.push_back(static_cast<char>(b));
+    if (eFoglia(figlio)) {
+        Foglia* f = comeFoglia(figlio);
+        unito.append(reinterpret_cast<const char*>(f->suffisso()), f->lunghezza);
+        Foglia* g = nuovaFoglia(reinterpret_cast<const unsigned char*>(unito.data()), unito.size(), std::move(f->elemento));
+        distruggiFoglia(f);
+        *rif = etichetta(g);
+    } else {
+        unito.append(reinterpret_cast<const char*>(prefisso(figlio)), figlio->lunghezzaPrefisso);
+        *rif = ricopia(figlio, reinterpret_cast<const unsigned char*>(unito.data()), unito.size());
+        ::operator delete(figlio);
+    }
+    ::operator delete(n);
+}
+/**
+ * @brief Metodo che cerca la foglia della chiave key.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return foglia della chiave, nullptr se la chiave non è presente.
+ */
+template <class E>
+typename ArtTree<E>::Foglia* ArtTree<E>::cerca(std::string_view key) const {
+    const unsigned char* k = reinterpret_cast<const unsigned char*>(key.data());
+    size_t d = 0;
+    Nodo* n = radice;
+    while (n != nullptr) {
+        if (eFoglia(n)) {
+            Foglia* f = comeFoglia(n);
+            bool uguale = f->lunghezza == key.size() - d && std::memcmp(f->suffisso(), k + d, f->lunghezza) == 0;
+            return uguale ? f : nullptr;
+        }
+        size_t lp = n->lunghezzaPrefisso;
+        if (key.size() - d < lp || std::memcmp(prefisso(n), k + d, lp) != 0)
+            return nullptr;
+        d += lp;
+        if (d == key.size())
+            return n->valore;
+        Nodo** figlio = trovaFiglio(n, k[d]);
+        if (figlio == nullptr)
+            return nullptr;
+        n = *figlio;
+        d++;
+    }
+    return nullptr;
+}
+/**
+ * @brief Metodo che inserisce la chiave key, con l'elemento costruito da args, se
+ * non è presente.
+ * Quando la chiave si separa dal prefisso di un nodo o dal suffisso di una foglia,
+ * il tratto comune diventa il prefisso di un nuovo Nodo4.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da inserire.
+ * @param args argomenti del costruttore dell'elemento.
+ * @return foglia della chiave e true se è stata inserita.
+ */
+template <class E>
+template <class... Args>
+std::pair<typename ArtTree<E>::Foglia*, bool> ArtTree<E>::inserisciSeAssente(std::string_view key, Args&&... args) {
+    const unsigned char* k = reinterpret_cast<const unsigned char*>(key.data());
+    size_t d = 0;
+    Nodo** rif = &radice;
+    while (true) {
+        Nodo* n = *rif;
+        if (n == nullptr) {
+            Foglia* f = nuovaFoglia(k + d, key.size() - d, std::forward<Args>(args)...);
+            *rif = etichetta(f);
+            numCoppie++;
+            return {f, true};
+        }
+
+        // Tratto in comune con il suffisso della foglia o con il prefisso del nodo
+        const unsigned char* tratto;
+        size_t lunghezza;
+        if (eFoglia(n)) {
+            tratto = comeFoglia(n)->suffisso();
+            lunghezza = comeFoglia(n)->lunghezza;
+        } else {
+            tratto = prefisso(n);
+            lunghezza = n->lunghezzaPrefisso;
+        }
+        size_t c = comune(tratto, lunghezza, k + d, key.size() - d);
+        if (eFoglia(n) && c == lunghezza && c == key.size() - d)
+            return {comeFoglia(n), false};
+
+        if (eFoglia(n) || c < lunghezza) {
+            // Divisione: il tratto comune diventa il prefisso di un nuovo Nodo4
+            Nodo* x = nuovoNodo(NODO4, tratto, c);
+            if (c == lunghezza) {
+                // solo per una foglia: la sua chiave termina nel nuovo nodo
+                Foglia* f = comeFoglia(n);
+                Foglia* g = nuovaFoglia(nullptr, 0, std::move(f->elemento));
+                distruggiFoglia(f);
+                x->valore = g;
+            } else if (eFoglia(n)) {
+                Foglia* f = comeFoglia(n);
+                unsigned char b = f->suffisso()[c];
+                std::memmove(f->suffisso(), f->suffisso() + c + 1, f->lunghezza - c - 1);
+                f->lunghezza -= static_cast<uint32_t>(c + 1);
+                aggiungiFiglio(&x, b, n);
+            } else {
+                unsigned char b = prefisso(n)[c];
+                std::memmove(prefisso(n), prefisso(n) + c + 1, lunghezza - c - 1);
+                n->lunghezzaPrefisso -= static_cast<uint32_t>(c + 1);
+                aggiungiFiglio(&x, b, n);
+            }
+            *rif = x;
+            Foglia* f;
+            if (d + c == key.size()) {
+                f = nuovaFoglia(nullptr, 0, std::forward<Args>(args)...);
+                x->valore = f;
+            } else {
+                f = nuovaFoglia(k + d + c + 1, key.size() - d - c - 1, std::forward<Args>(args)...);
+                aggiungiFiglio(rif, k[d + c], etichetta(f));
+            }
+            numCoppie++;
+            return {f, true};
+        }
+
+        d += lunghezza;
+        if (d == key.size()) {
+            if (n->valore != nullptr)
+                return {n->valore, false};
+            n->valore = nuovaFoglia(nullptr, 0, std::forward<Args>(args)...);
+            numCoppie++;
+            return {n->valore, true};
+        }
+        Nodo** figlio = trovaFiglio(n, k[d]);
+        if (figlio == nullptr) {
+            Foglia* f = nuovaFoglia(k + d + 1, key.size() - d - 1, std::forward<Args>(args)...);
+            aggiungiFiglio(rif, k[d], etichetta(f));
+            numCoppie++;
+            return {f, true};
+        }
+        rif = figlio;
+        d++;
+    }
+}
+/**
+ * @brief Metodo che cancella la chiave key dal sottoalbero in posizione rif, che
+ * inizia dal byte d della chiave, e ne ripristina la compressione.
+ * @tparam E tipo dell'elemento.
+ * @param rif posizione della radice del sottoalbero.
+ * @param key chiave da cancellare.
+ * @param d byte della chiave da cui inizia il sottoalbero.
+ * @return true se la chiave era presente, false altrimenti.
+ */
+template <class E>
+bool ArtTree<E>::cancellaIn(Nodo** rif, std::string_view key, size_t d) {
+    const unsigned char* k = reinterpret_cast<const unsigned char*>(key.data());
+    Nodo* n = *rif;
+    if (n == nullptr)
+        return false;
+    if (eFoglia(n)) {
+        Foglia* f = comeFoglia(n);
+        if (f->lunghezza != key.size() - d || std::memcmp(f->suffisso(), k + d, f->lunghezza) != 0)
+            return false;
+        distruggiFoglia(f);
+        *rif = nullptr;
+        return true;
+    }
+    size_t lp = n->lunghezzaPrefisso;
+    if (key.size() - d < lp || std::memcmp(prefisso(n), k + d, lp) != 0)
+        return false;
+    d += lp;
+    if (d == key.size()) {
+        if (n->valore == nullptr)
+            return false;
+        distruggiFoglia(n->valore);
+        n->valore = nullptr;
+    } else {
+        Nodo** figlio = trovaFiglio(n, k[d]);
+        if (figlio == nullptr || !cancellaIn(figlio, key, d + 1))
+            return false;
+        if (*figlio == nullptr)
+            rimuoviFiglio(rif, k[d]);
+    }
+    compatta(rif);
+    return true;
+}
+/**
+ * @brief Metodo che visita il sottoalbero di radice n in ordine lessicografico.
+ * @tparam E tipo dell'elemento.
+ * @tparam F funzione con parametri (const std::string& chiave, const E& elemento).
+ * @param n radice del sottoalbero.
+ * @param chiave chiave ricostruita fino a n escluso; al ritorno è invariata.
+ * @param f funzione da applicare a ogni coppia.
+ */
+template <class E>
+template <class F>
+void ArtTree<E>::visita(const Nodo* n, std::string& chiave, F& f) {
+    size_t lunghezza = chiave.size();
+    if (eFoglia(n)) {
+        const Foglia* foglia = comeFoglia(n);
+        chiave.append(reinterpret_cast<const char*>(foglia->suffisso()), foglia->lunghezza);
+        f(static_cast<const std::string&>(chiave), static_cast<const E&>(foglia->elemento));
+        chiave.resize(lunghezza);
+        return;
+    }
+    chiave.append(reinterpret_cast<const char*>(prefisso(n)), n->lunghezzaPrefisso);
+    if (n->valore != nullptr)
+        f(static_cast<const std::string&>(chiave), static_cast<const E&>(n->valore->elemento));
+    perOgniFiglio(n, [&chiave, &f](unsigned char b, Nodo* figlio) {
+        chiave.push_back(static_cast<char>(b));
+        visita(figlio, chiave, f);
+        chiave.pop_back();
+    });
+    chiave.resize(lunghezza);
+}
+/**
+ * @brief Metodo che applica f a ogni coppia del dizionario, in ordine lessicografico.
+ * @tparam E tipo dell'elemento.
+ * @tparam F funzione con parametri (const std::string& chiave, const E& elemento).
+ * @param f funzione da applicare.
+ */
+template <class E>
+template <class F>
+void ArtTree<E>::perOgni(F f) const {
+    std::string chiave;
+    if (radice != nullptr)
+        visita(radice, chiave, f);
+}
+/**
+ * @brief Metodo che applica f, in ordine lessicografico, alle sole coppie la cui
+ * chiave inizia con p: raggiunto il sottoalbero del prefisso, non visita altro.
+ * @tparam E tipo dell'elemento.
+ * @tparam F funzione con parametri (const std::string& chiave, const E& elemento).
+ * @param p prefisso.
+ * @param f funzione da applicare.
+ */
+template <class E>
+template <class F>
+void ArtTree<E>::perOgniConPrefisso(const Key& p, F f) const {
+    const unsigned char* k = reinterpret_cast<const unsigned char*>(p.data());
+    std::string chiave;
+    size_t d = 0;
+    Nodo* n = radice;
+    while (n != nullptr) {
+        const unsigned char* tratto;
+        size_t lunghezza;
+        if (eFoglia(n)) {
+            tratto = comeFoglia(n)->suffisso();
+            lunghezza = comeFoglia(n)->lunghezza;
+        } else {
+            tratto = prefisso(n);
+            lunghezza = n->lunghezzaPrefisso;
+        }
+        size_t resto = p.size() - d;
+        if (resto <= lunghezza) {
+            // Il prefisso termina dentro questo nodo: tutto il sottoalbero è compreso
+            if (std::memcmp(tratto, k + d, resto) == 0)
+                visita(n, chiave, f);
+            return;
+        }
+        if (eFoglia(n) || std::memcmp(tratto, k + d, lunghezza) != 0)
+            return;
+        chiave.append(reinterpret_cast<const char*>(tratto), lunghezza);
+        d += lunghezza;
+        Nodo** figlio = trovaFiglio(n, k[d]);
+        if (figlio == nullptr)
+            return;
+        chiave.push_back(static_cast<char>(k[d]));
+        n = *figlio;
+        d++;
+    }
+}
+/**
+ * @brief Metodo che inserisce una coppia nel dizionario.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia da inserire.
+ */
+template <class E>
+void ArtTree<E>::inserisci(const Couple<Key,Element>& c) {
+    if (!inserisciSeAssente(c.getKey(), c.getElement()).second)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+}
+/**
+ * @brief Metodo che inserisce una coppia nel dizionario spostandone l'elemento.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia da spostare nel dizionario.
+ */
+template <class E>
+void ArtTree<E>::inserisci(Couple<Key,Element>&& c) {
+    if (!inserisciSeAssente(c.getKey(), std::move(c.getElement())).second)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+}
+/**
+ * @brief Metodo che costruisce l'elemento a partire da args solo se key non è presente.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia.
+ * @param args argomenti del costruttore dell'elemento.
+ * @return puntatore all'elemento associato a key e true se è stato inserito.
+ */
+template <class E>
+template <class... Args>
+std::pair<typename ArtTree<E>::Element*, bool> ArtTree<E>::try_emplace(const Key& key, Args&&... args) {
+    std::pair<Foglia*, bool> r = inserisciSeAssente(key, std::forward<Args>(args)...);
+    return {&r.first->elemento, r.second};
+}
+/**
+ * @brief Metodo che inserisce la coppia (key, element) o, se key è già presente,
+ * assegna element all'elemento esistente.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia.
+ * @param element elemento da inserire o assegnare.
+ * @return puntatore all'elemento associato a key e true se è stato inserito.
+ */
+template <class E>
+template <class E1>
+std::pair<typename ArtTree<E>::Element*, bool> ArtTree<E>::insert_or_assign(const Key& key, E1&& element) {
+    std::pair<Foglia*, bool> r = inserisciSeAssente(key, std::forward<E1>(element));
+    if (!r.second)
+        r.first->elemento = std::forward<E1>(element);
+    return {&r.first->elemento, r.second};
+}
+/**
+ * @brief Metodo che cancella la coppia con chiave key.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia da cancellare.
+ */
+template <class E>
+void ArtTree<E>::cancella(const Key& key) {
+    if (numCoppie == 0)
+        throw std::out_of_range("Il dizionario è vuoto.");
+    if (!cancellaIn(&radice, key, 0))
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    numCoppie--;
+}
+/**
+ * @brief Metodo che recupera l'elemento associato alla chiave key.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return elemento associato alla chiave.
+ */
+template <class E>
+typename ArtTree<E>::Element ArtTree<E>::recupera(const Key& key) const {
+    Foglia* f = cerca(key);
+    if (f == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    return f->elemento;
+}
+/**
+ * @brief Metodo che aggiorna l'elemento associato alla chiave key.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia da aggiornare.
+ * @param element nuovo elemento.
+ */
+template <class E>
+void ArtTree<E>::aggiorna(const Key& key, const Element& element) {
+    Foglia* f = cerca(key);
+    if (f == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    f->elemento = element;
+}
+/**
+ * @brief Metodo che restituisce un puntatore all'elemento associato alla chiave key.
+ * Il dizionario non memorizza coppie: al posto della coppia si ottiene l'elemento.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore all'elemento, nullptr se la chiave non è presente.
+ */
+template <class E>
+typename ArtTree<E>::Element* ArtTree<E>::find(const Key& key) {
+    Foglia* f = cerca(key);
+    return f == nullptr ? nullptr : &f->elemento;
+}
+/**
+ * @brief Versione costante di find.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore all'elemento, nullptr se la chiave non è presente.
+ */
+template <class E>
+const typename ArtTree<E>::Element* ArtTree<E>::find(const Key& key) const {
+    Foglia* f = cerca(key);
+    return f == nullptr ? nullptr : &f->elemento;
+}
+/**
+ * @brief Metodo che recupera l'elemento associato a key senza sollevare eccezioni.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param element riceve una copia dell'elemento, se la chiave è presente.
+ * @return true se la chiave è presente, false altrimenti.
+ */
+template <class E>
+bool ArtTree<E>::tryGet(const Key& key, Element& element) const {
+    Foglia* f = cerca(key);
+    if (f == nullptr)
+        return false;
+    element = f->elemento;
+    return true;
+}
+/**
+ * @brief Metodo che svuota il dizionario.
+ * @tparam E tipo dell'elemento.
+ */
+template <class E>
+void ArtTree<E>::clear() {
+    distruggi(radice);
+    radice = nullptr;
+    numCoppie = 0;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutte le chiavi del dizionario,
+ * in ordine lessicografico.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutte le chiavi del dizionario.
+ */
+template <class E>
+VectorList<typename ArtTree<E>::Key> ArtTree<E>::keys() const {
+    VectorList<Key> keys;
+    perOgni([&keys](const std::string& k, const E&) {keys.inserisciCoda(k);});
+    return keys;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutti gli elementi del dizionario,
+ * nell'ordine lessicografico delle rispettive chiavi.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutti gli elementi del dizionario.
+ */
+template <class E>
+VectorList<E> ArtTree<E>::values() const {
+    VectorList<E> values;
+    perOgni([&values](const std::string&, const E& e) {values.inserisciCoda(e);});
+    return values;
+}
+/**
+ * @brief Operatore di assegnamento.
+ * @tparam E tipo dell'elemento.
+ * @param t dizionario da assegnare.
+ * @return riferimento al dizionario.
+ */
+template <class E>
+ArtTree<E>& ArtTree<E>::operator=(const ArtTree<E>& t) {
+    if (this != &t) {
+        Nodo* c = copia(t.radice);
+        distruggi(radice);
+        radice = c;
+        numCoppie = t.numCoppie;
+    }
+    return *this;
+}
+/**
+ * @brief Operatore di uguaglianza.
+ * @tparam E tipo dell'elemento.
+ * @param t dizionario da confrontare.
+ * @return true se i dizionari contengono le stesse chiavi, false altrimenti.
+ */
+template <class E>
+bool ArtTree<E>::operator==(const ArtTree<E>& t) const {
+    if (numCoppie != t.numCoppie)
+        return false;
+    bool uguali = true;
+    perOgni([&uguali, &t](const std::string& k, const E&) {
+        if (uguali && !t.appartiene(k))
+            uguali = false;
+    });
+    return uguali;
+}
+/**
+ * @brief Operatore di disuguaglianza.
+ * @tparam E tipo dell'elemento.
+ * @param t dizionario da confrontare.
+ * @return true se i dizionari sono diversi, false altrimenti.
+ */
+template <class E>
+bool ArtTree<E>::operator!=(const ArtTree<E>& t) const {
+    return !(*this == t);
+}
+/**
+ * @brief Operatore di stream: stampa le coppie in ordine lessicografico.
+ * @tparam E tipo dell'elemento.
+ * @param os stream di output.
+ * @param t dizionario da stampare.
+ * @return stream di output.
+ */
+template <class E>
+std::ostream& operator<<(std::ostream& os, const ArtTree<E>& t) {
+    os << "{";
+    bool primo = true;
+    t.perOgni([&os, &primo](const std::string& k, const E& e) {
+        if (!primo)
+            os << ", ";
+        os << k << ": " << e;
+        primo = false;
+    });
+    os << "}";
+    return os;
+}
+
+#endif //DICTIONARY_ARTTREE_H
@@ -0,0 +1,964 @@
+#ifndef DICTIONARY_BTREE_H
+#define DICTIONARY_BTREE_H
+
+#include "Dictionary.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Classe che rappresenta un dizionario ordinato basato su un B+-albero.
+ * Le coppie sono memorizzate, ordinate per chiave, solo nelle foglie, collegate tra
+ * loro da sinistra a destra; i nodi interni contengono le sole chiavi separatrici,
+ * in un array contiguo, e i puntatori ai figli. Ogni nodo occupa circa BYTE_NODO
+ * byte, cioè alcune linee di cache: la ricerca in un nodo è una ricerca binaria su
+ * memoria contigua e l'altezza dell'albero resta di pochi livelli anche con milioni
+ * di chiavi.
+ * <br>
+ * Inserimento, cancellazione e ricerca costano O(log n). Le coppie si visitano in
+ * ordine crescente di chiave con un ciclo for sul dizionario o su entries();
+ * lower_bound(), upper_bound(), intervallo() e prefisso() individuano in O(log n)
+ * l'inizio e la fine di una visita parziale. keys() e values() sono ordinati.
+ * Ogni operazione di modifica invalida gli iteratori.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam C relazione d'ordine stretta tra le chiavi, per default std::less<K>.
+ */
+template <class K, class E, class C = std::less<K>>
+class BTree : public Dictionary<K,E> {
+    struct Nodo;
+    struct Foglia;
+    struct Interno;
+
+public:
+    typedef typename Dictionary<K,E>::Key Key;
+    typedef typename Dictionary<K,E>::Element Element;
+
+    /**
+     * @brief Iteratore in avanti sulle coppie del dizionario, in ordine crescente di chiave.
+     * @tparam Costante true per un iteratore che non consente di modificare le coppie.
+     */
+    template <bool Costante>
+    class Iteratore {
+        typedef typename std::conditional<Costante, const Couple<K,E>, Couple<K,E>>::type Voce;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Couple<K,E> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Voce* pointer;
+        typedef Voce& reference;
+
+        Iteratore() : f(nullptr), i(0) {}
+        Iteratore(const Iteratore<false>& it) : f(it.f), i(it.i) {}
+
+        reference operator*() const {return f->coppie()[i];}
+        pointer operator->() const {return &f->coppie()[i];}
+        Iteratore& operator++() {
+            if (++i == f->n) {
+                f = f->successiva;
+                i = 0;
+            }
+            return *this;
+        }
+        Iteratore operator++(int) {
+            Iteratore it = *this;
+            ++*this;
+            return it;
+        }
+        bool operator==(const Iteratore& it) const {return f == it.f && i == it.i;}
+        bool operator!=(const Iteratore& it) const {return !(*this == it);}
+
+    private:
+        friend class BTree;
+        template <bool> friend class Iteratore;
+        Iteratore(Foglia* f, int i) : f(f), i(i) {
+            if (f != nullptr && i == f->n) {    // oltre l'ultima coppia della foglia
+                this->f = f->successiva;
+                this->i = 0;
+            }
+        }
+
+        Foglia* f;      // nullptr per l'iteratore di fine
+        int i;
+    };
+    typedef Iteratore<false> iterator;
+    typedef Iteratore<true> const_iterator;
+
+    BTree();
+    BTree(const BTree&);
+    ~BTree();
+
+    bool dizionarioVuoto() const {return numCoppie == 0;}
+    void inserisci(const Couple<Key,Element>&);
+    void inserisci(Couple<Key,Element>&&);
+    void cancella(const Key&);
+    Element recupera(const Key&) const;
+    bool appartiene(const Key& key) const {return find(key) != nullptr;}
+    void aggiorna(const Key&, const Element&);
+
+    Couple<K,E>* find(const Key&);
+    const Couple<K,E>* find(const Key&) const;
+    bool tryGet(const Key&, Element&) const;
+
+    template<class... Args>
+    std::pair<Couple<K,E>*, bool> try_emplace(const Key&, Args&&...);
+    template<class E1>
+    std::pair<Couple<K,E>*, bool> insert_or_assign(const Key&, E1&&);
+
+    void clear();
+    int lunghezza() const {return numCoppie;}
+    int altezza() const {return livelli;}
+    VectorList<K> keys() const;
+    VectorList<E> values() const;
+
+    iterator begin() {return iterator(prima, 0);}
+    iterator end() {return iterator();}
+    const_iterator begin() const {return const_iterator(prima, 0);}
+    const_iterator end() const {return const_iterator();}
+    Intervallo<iterator> entries() {return Intervallo<iterator>(begin(), end());}
+    Intervallo<const_iterator> entries() const {return Intervallo<const_iterator>(begin(), end());}
+
+    iterator lower_bound(const Key&);
+    const_iterator lower_bound(const Key&) const;
+    iterator upper_bound(const Key&);
+    const_iterator upper_bound(const Key&) const;
+    Intervallo<const_iterator> intervallo(const Key&, const Key&) const;
+    Intervallo<const_iterator> prefisso(const Key&) const;
+
+    BTree<K,E,C>& operator=(const BTree<K,E,C>&);
+    bool operator==(const BTree<K,E,C>&) const;
+    bool operator!=(const BTree<K,E,C>&) const;
+
+    template<class K1, class E1, class C1>
+    friend std::ostream& operator<<(std::ostream&, const BTree<K1,E1,C1>&);
+
+private:
+    static constexpr size_t BYTE_NODO = 512;
+    static constexpr int FOGLIA = sizeof(Couple<K,E>) * 8 > BYTE_NODO ? 8 : int(BYTE_NODO / sizeof(Couple<K,E>));
+    static constexpr int INTERNO = sizeof(K) * 8 > BYTE_NODO ? 8 : int(BYTE_NODO / sizeof(K));
+    static constexpr int MIN_FOGLIA = FOGLIA / 2;       // coppie minime di una foglia diversa dalla radice
+    static constexpr int MIN_INTERNO = INTERNO / 2;     // chiavi minime di un nodo interno diverso dalla radice
+    static constexpr int ALTEZZA_MAX = 32;              // ampiamente sufficiente: ogni nodo interno ha almeno 5 figli
+
+    struct Nodo {
+        int n = 0;      // coppie di una foglia, chiavi di un nodo interno
+    };
+
+    /**
+     * @brief Foglia: fino a FOGLIA coppie ordinate, memorizzate in linea.
+     */
+    struct Foglia : Nodo {
+        Foglia() : successiva(nullptr) {}
+        Foglia(const Foglia&) = delete;
+        ~Foglia() {
+            for (int i = 0; i < this->n; i++)
+                coppie()[i].~Couple<K,E>();
+        }
+        Couple<K,E>* coppie() {return reinterpret_cast<Couple<K,E>*>(spazio);}
+        const Couple<K,E>* coppie() const {return reinterpret_cast<const Couple<K,E>*>(spazio);}
+
+        Foglia* successiva;
+        alignas(Couple<K,E>) unsigned char spazio[FOGLIA * sizeof(Couple<K,E>)];
+    };
+
+    /**
+     * @brief Nodo interno: n chiavi separatrici e n + 1 figli. Tutte le chiavi del
+     * figlio i sono minori della chiave i, quelle del figlio i + 1 maggiori o uguali.
+     * C'è spazio per una chiave e un figlio in più, usati durante la divisione.
+     */
+    struct Interno : Nodo {
+        Interno() {}
+        Interno(const Interno&) = delete;
+        ~Interno() {
+            for (int i = 0; i < this->n; i++)
+                chiavi()[i].~K();
+        }
+        K* chiavi() {return reinterpret_cast<K*>(spazio);}
+        const K* chiavi() const {return reinterpret_cast<const K*>(spazio);}
+
+        alignas(K) unsigned char spazio[(INTERNO + 1) * sizeof(K)];
+        Nodo* figli[INTERNO + 2];
+    };
+
+    template <class T, class V>
+    static void inserisciIn(T*, int, int, V&&);
+    template <class T>
+    static void rimuoviDa(T*, int, int);
+    static void inserisciFiglio(Interno*, int, Nodo*);
+    static void rimuoviFiglio(Interno*, int);
+
+    int figlio(const Interno*, const Key&) const;
+    int posizione(const Foglia*, const Key&) const;
+    Foglia* discendi(const Key&, Interno**, int*) const;
+    template<class... Args>
+    std::pair<Couple<K,E>*, bool> inserisciSeAssente(const Key&, Args&&...);
+    void inserisciSeparatore(Interno**, int*, int, K, Nodo*);
+    void riequilibraFoglia(Foglia*, Interno*, int);
+    void riequilibraInterno(Interno*, Interno*, int);
+    void libera(Nodo*, int);
+    Nodo* copia(const Nodo*, int, Foglia*&);
+
+    Nodo* radice;
+    Foglia* prima;      // foglia più a sinistra, la stessa per tutta la vita dell'albero
+    int livelli;        // livelli di nodi interni: 0 se la radice è una foglia
+    int numCoppie;
+    C minore;
+};
+/**
+ * @brief Costruttore di default che inizializza un dizionario vuoto, formato da una
+ * sola foglia.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class C>
+BTree<K,E,C>::BTree() : livelli(0), numCoppie(0) {
+    prima = new Foglia();
+    radice = prima;
+}
+/**
+ * @brief Costruttore di copia.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param t dizionario da copiare.
+ */
+template <class K, class E, class C>
+BTree<K,E,C>::BTree(const BTree& t) : livelli(t.livelli), numCoppie(t.numCoppie), minore(t.minore) {
+    Foglia* ultima = nullptr;
+    prima = nullptr;
+    radice = copia(t.radice, 0, ultima);
+}
+/**
+ * @brief Distruttore.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class C>
+BTree<K,E,C>::~BTree() {
+    libera(radice, 0);
+}
+/**
+ * @brief Metodo che inserisce v nella posizione pos dell'array a di n oggetti,
+ * spostando di una posizione quelli successivi. La posizione n deve essere libera.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param a array di oggetti.
+ * @param n numero di oggetti costruiti in a.
+ * @param pos posizione in cui inserire, tra 0 e n.
+ * @param v oggetto da inserire.
+ */
+template <class K, class E, class C>
+template <class T, class V>
+void BTree<K,E,C>::inserisciIn(T* a, int n, int pos, V&& v) {
+    if (pos == n) {
+        new (&a[n]) T(std::forward<V>(v));
+        return;
+    }
+    new (&a[n]) T(std::move(a[n - 1]));
+    for (int i = n - 1; i > pos; i--)
+        a[i] = std::move(a[i - 1]);
+    a[pos] = std::forward<V>(v);
+}
+/**
+ * @brief Metodo che rimuove l'oggetto in posizione pos dall'array a di n oggetti,
+ * spostando di una posizione quelli successivi.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param a array di oggetti.
+ * @param n numero di oggetti costruiti in a.
+ * @param pos posizione da rimuovere, tra 0 e n - 1.
+ */
+template <class K, class E, class C>
+template <class T>
+void BTree<K,E,C>::rimuoviDa(T* a, int n, int pos) {
+    for (int i = pos; i < n - 1; i++)
+        a[i] = std::move(a[i + 1]);
+    a[n - 1].~T();
+}
+/**
+ * @brief Metodo che inserisce il figlio f in posizione j del nodo interno x, i cui
+ * figli sono x->n + 1.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param x nodo interno.
+ * @param j posizione del nuovo figlio.
+ * @param f figlio da inserire.
+ */
+template <class K, class E, class C>
+void BTree<K,E,C>::inserisciFiglio(Interno* x, int j, Nodo* f) {
+    std::memmove(&x->figli[j + 1], &x->figli[j], sizeof(Nodo*) * (x->n + 1 - j));
+    x->figli[j] = f;
+}
+/**
+ * @brief Metodo che rimuove il figlio in posizione j del nodo interno x, i cui figli
+ * sono x->n + 1.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param x nodo interno.
+ * @param j posizione del figlio da rimuovere.
+ */
+template <class K, class E, class C>
+void BTree<K,E,C>::rimuoviFiglio(Interno* x, int j) {
+    std::memmove(&x->figli[j], &x->figli[j + 1], sizeof(Nodo*) * (x->n - j));
+}
+/**
+ * @brief Metodo che sceglie il figlio di x in cui proseguire la ricerca di key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param x nodo interno.
+ * @param key chiave da cercare.
+ * @return indice del figlio, tra 0 e x->n.
+ */
+template <class K, class E, class C>
+int BTree<K,E,C>::figlio(const Interno* x, const Key& key) const {
+    return static_cast<int>(std::upper_bound(x->chiavi(), x->chiavi() + x->n, key, minore) - x->chiavi());
+}
+/**
+ * @brief Metodo che individua la prima coppia di f con chiave non minore di key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param f foglia.
+ * @param key chiave da cercare.
+ * @return indice della coppia, f->n se tutte le chiavi di f sono minori di key.
+ */
+template <class K, class E, class C>
+int BTree<K,E,C>::posizione(const Foglia* f, const Key& key) const {
+    const Couple<K,E>* c = f->coppie();
+    return static_cast<int>(std::lower_bound(c, c + f->n, key, [this](const Couple<K,E>& a, const Key& b) {
+        return minore(a.getKey(), b);
+    }) - c);
+}
+/**
+ * @brief Metodo che scende dalla radice alla foglia in cui si trova, o andrebbe
+ * inserita, la chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param percorso se non nullo, riceve i nodi interni attraversati, dalla radice.
+ * @param indici se non nullo, riceve per ogni nodo attraversato l'indice del figlio scelto.
+ * @return foglia della chiave.
+ */
+template <class K, class E, class C>
+typename BTree<K,E,C>::Foglia* BTree<K,E,C>::discendi(const Key& key, Interno** percorso, int* indici) const {
+    Nodo* nodo = radice;
+    for (int l = 0; l < livelli; l++) {
+        Interno* x = static_cast<Interno*>(nodo);
+        int j = figlio(x, key);
+        if (percorso != nullptr) {
+            percorso[l] = x;
+            indici[l] = j;
+        }
+        nodo = x->figli[j];
+    }
+    return static_cast<Foglia*>(nodo);
+}
+/**
+ * @brief Metodo che inserisce la coppia costruita da args se la chiave key non è presente.
+ * Una foglia piena viene divisa in due prima dell'inserimento e la nuova foglia
+ * viene registrata nel padre, dividendo a loro volta i nodi interni pieni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia.
+ * @param args argomenti del costruttore della coppia.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita.
+ */
+template <class K, class E, class C>
+template <class... Args>
+std::pair<Couple<K,E>*, bool> BTree<K,E,C>::inserisciSeAssente(const Key& key, Args&&... args) {
+    Interno* percorso[ALTEZZA_MAX];
+    int indici[ALTEZZA_MAX];
+    Foglia* f = discendi(key, percorso, indici);
+    int pos = posizione(f, key);
+    if (pos < f->n && !minore(key, f->coppie()[pos].getKey()))
+        return {&f->coppie()[pos], false};
+
+    Couple<K,E> c(std::forward<Args>(args)...);
+    if (f->n < FOGLIA) {
+        inserisciIn(f->coppie(), f->n, pos, std::move(c));
+        f->n++;
+        numCoppie++;
+        return {&f->coppie()[pos], true};
+    }
+
+    // Divisione: f conserva le prime m coppie, d riceve le altre
+    Foglia* d = new Foglia();
+    int m = (FOGLIA + 1) / 2;
+    for (int i = m; i < FOGLIA; i++) {
+        new (&d->coppie()[i - m]) Couple<K,E>(std::move(f->coppie()[i]));
+        f->coppie()[i].~Couple<K,E>();
+    }
+    d->n = FOGLIA - m;
+    f->n = m;
+    d->successiva = f->successiva;
+    f->successiva = d;
+
+    Couple<K,E>* inserita;
+    if (pos <= m) {
+        inserisciIn(f->coppie(), f->n, pos, std::move(c));
+        f->n++;
+        inserita = &f->coppie()[pos];
+    } else {
+        inserisciIn(d->coppie(), d->n, pos - m, std::move(c));
+        d->n++;
+        inserita = &d->coppie()[pos - m];
+    }
+    inserisciSeparatore(percorso, indici, livelli, d->coppie()[0].getKey(), d);
+    numCoppie++;
+    return {inserita, true};
+}
+/**
+ * @brief Metodo che registra nel padre il nodo destro nato dalla divisione di un
+ * suo figlio, risalendo il percorso finché un nodo interno non ha spazio.
+ * Se anche la radice si divide, l'albero cresce di un livello.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param percorso nodi interni attraversati dalla radice.
+ * @param indici indice del figlio scelto in ciascun nodo di percorso.
+ * @param livello numero di nodi di percorso sopra il nodo diviso.
+ * @param separatore chiave minima del sottoalbero destro.
+ * @param destro nodo nato dalla divisione.
+ */
+template <class K, class E, class C>
+void BTree<K,E,C>::inserisciSeparatore(Interno** percorso, int* indici, int livello, K separatore, Nodo* destro) {
+    while (livello > 0) {
+        livello--;
+        Interno* x = percorso[livello];
+        int j = indici[livello];
+        inserisciIn(x->chiavi(), x->n, j, std::move(separatore));
+        inserisciFiglio(x, j + 1, destro);
+        x->n++;
+        if (x->n <= INTERNO)
+            return;
+
+        // Divisione: la chiave centrale sale nel padre
+        Interno* d = new Interno();
+        int m = x->n / 2;
+        separatore = std::move(x->chiavi()[m]);
+        for (int i = m + 1; i < x->n; i++)
+            new (&d->chiavi()[i - m - 1]) K(std::move(x->chiavi()[i]));
+        std::memcpy(d->figli, &x->figli[m + 1], sizeof(Nodo*) * (x->n - m));
+        for (int i = m; i < x->n; i++)
+            x->chiavi()[i].~K();
+        d->n = x->n - m - 1;
+        x->n = m;
+        destro = d;
+    }
+    Interno* r = new Interno();
+    new (&r->chiavi()[0]) K(std::move(separatore));
+    r->figli[0] = radice;
+    r->figli[1] = destro;
+    r->n = 1;
+    radice = r;
+    livelli++;
+}
+/**
+ * @brief Metodo che inserisce una coppia nel dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia da inserire.
+ */
+template <class K, class E, class C>
+void BTree<K,E,C>::inserisci(const Couple<Key,Element>& c) {
+    if (!inserisciSeAssente(c.getKey(), c).second)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+}
+/**
+ * @brief Metodo che inserisce una coppia nel dizionario spostandola, senza copiarla.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia da spostare nel dizionario.
+ */
+template <class K, class E, class C>
+void BTree<K,E,C>::inserisci(Couple<Key,Element>&& c) {
+    if (!inserisciSeAssente(c.getKey(), std::move(c)).second)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+}
+/**
+ * @brief Metodo che costruisce l'elemento a partire da args solo se key non è presente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia.
+ * @param args argomenti del costruttore dell'elemento.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita.
+ */
+template <class K, class E, class C>
+template <class... Args>
+std::pair<Couple<K,E>*, bool> BTree<K,E,C>::try_emplace(const Key& key, Args&&... args) {
+    return inserisciSeAssente(key, std::piecewise_construct, key, std::forward<Args>(args)...);
+}
+/**
+ * @brief Metodo che inserisce la coppia (key, element) o, se key è già presente,
+ * assegna element all'elemento esistente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia.
+ * @param element elemento da inserire o assegnare.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita.
+ */
+template <class K, class E, class C>
+template <class E1>
+std::pair<Couple<K,E>*, bool> BTree<K,E,C>::insert_or_assign(const Key& key, E1&& element) {
+    std::pair<Couple<K,E>*, bool> r = inserisciSeAssente(key, std::piecewise_construct, key, std::forward<E1>(element));
+    if (!r.second)
+        r.first->getElement() = std::forward<E1>(element);
+    return r;
+}
+/**
+ * @brief Metodo che cancella la coppia con chiave key.
+ * Una foglia o un nodo interno rimasti con meno della metà del contenuto massimo
+ * prendono in prestito un elemento da un fratello adiacente o, se entrambi sono al
+ * minimo, si fondono con uno di essi; se la radice interna resta senza chiavi,
+ * l'albero si abbassa di un livello.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia da cancellare.
+ */
+template <class K, class E, class C>
+void BTree<K,E,C>::cancella(const Key& key) {
+    if (numCoppie == 0)
+        throw std::out_of_range("Il dizionario è vuoto.");
+    Interno* percorso[ALTEZZA_MAX];
+    int indici[ALTEZZA_MAX];
+    Foglia* f = discendi(key, percorso, indici);
+    int pos = posizione(f, key);
+    if (pos == f->n || minore(key, f->coppie()[pos].getKey()))
+        throw std::out_of_range("Error: la chiave non e' presente.");
+
+    rimuoviDa(f->coppie(), f->n, pos);
+    f->n--;
+    numCoppie--;
+    if (livelli == 0 || f->n >= MIN_FOGLIA)
+        return;
+
+    riequilibraFoglia(f, percorso[livelli - 1], indici[livelli - 1]);
+    for (int l = livelli - 1; l > 0 && percorso[l]->n < MIN_INTERNO; l--)
+        riequilibraInterno(percorso[l], percorso[l - 1], indici[l - 1]);
+    if (radice->n == 0) {
+        Interno* r = static_cast<Interno*>(radice);
+        radice = r->figli[0];
+        delete r;
+        livelli--;
+    }
+}
+/**
+ * @brief Metodo che riporta al minimo la foglia f, figlia j del nodo interno p,
+ * con un prestito da una foglia sorella o fondendola con essa.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param f foglia con MIN_FOGLIA - 1 coppie.
+ * @param p padre di f.
+ * @param j indice di f tra i figli di p.
+ */
+template <class K, class E, class C>
+void BTree<K,E,C>::riequilibraFoglia(Foglia* f, Interno* p, int j) {
+    Foglia* sinistra = j > 0 ? static_cast<Foglia*>(p->figli[j - 1]) : nullptr;
+    Foglia* destra = j < p->n ? static_cast<Foglia*>(p->figli[j + 1]) : nullptr;
+    if (sinistra != nullptr && sinistra->n > MIN_FOGLIA) {
+        inserisciIn(f->coppie(), f->n, 0, std::move(sinistra->coppie()[sinistra->n - 1]));
+        f->n++;
+        sinistra->coppie()[--sinistra->n].~Couple<K,E>();
+        p->chiavi()[j - 1] = f->coppie()[0].getKey();
+        return;
+    }
+    if (destra != nullptr && destra->n > MIN_FOGLIA) {
+        new (&f->coppie()[f->n++]) Couple<K,E>(std::move(destra->coppie()[0]));
+        rimuoviDa(destra->coppie(), destra->n--, 0);
+        p->chiavi()[j] = destra->coppie()[0].getKey();
+        return;
+    }
+
+    // Fusione della foglia di destra (a) in quella di sinistra (b)
+    Foglia* b = sinistra != nullptr ? sinistra : f;
+    Foglia* a = sinistra != nullptr ? f : destra;
+    int k = sinistra != nullptr ? j - 1 : j;     // separatore tra b e a
+    for (int i = 0; i < a->n; i++)
+        new (&b->coppie()[b->n + i]) Couple<K,E>(std::move(a->coppie()[i]));
+    b->n += a->n;
+    b->successiva = a->successiva;
+    rimuoviDa(p->chiavi(), p->n, k);
+    rimuoviFiglio(p, k + 1);
+    p->n--;
+    delete a;
+}
+/**
+ * @brief Metodo che riporta al minimo il nodo interno x, figlio j del nodo interno p,
+ * ruotando una chiave attraverso p da un fratello o fondendolo con esso.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param x nodo interno con MIN_INTERNO - 1 chiavi.
+ * @param p padre di x.
+ * @param j indice di x tra i figli di p.
+ */
+template <class K, class E, class C>
+void BTree<K,E,C>::riequilibraInterno(Interno* x, Interno* p, int j) {
+    Interno* sinistra = j > 0 ? static_cast<Interno*>(p->figli[j - 1]) : nullptr;
+    Interno* destra = j < p->n ? static_cast<Interno*>(p->figli[j + 1]) : nullptr;
+    if (sinistra != nullptr && sinistra->n > MIN_INTERNO) {
+        inserisciIn(x->chiavi(), x->n, 0, std::move(p->chiavi()[j - 1]));
+        inserisciFiglio(x, 0, sinistra->figli[sinistra->n]);
+        x->n++;
+        p->chiavi()[j - 1] = std::move(sinistra->chiavi()[sinistra->n - 1]);
+        sinistra->chiavi()[--sinistra->n].~K();
+        return;
+    }
+    if (destra != nullptr && destra->n > MIN_INTERNO) {
+        new (&x->chiavi()[x->n]) K(std::move(p->chiavi()[j]));
+        x->figli[x->n + 1] = destra->figli[0];
+        x->n++;
+        p->chiavi()[j] = std::move(destra->chiavi()[0]);
+        rimuoviFiglio(destra, 0);
+        rimuoviDa(destra->chiavi(), destra->n--, 0);
+        return;
+    }
+
+    // Fusione del nodo di destra (a) in quello di sinistra (b), con il separatore in mezzo
+    Interno* b = sinistra != nullptr ? sinistra : x;
+    Interno* a = sinistra != nullptr ? x : destra;
+    int k = sinistra != nullptr ? j - 1 : j;
+    new (&b->chiavi()[b->n]) K(std::move(p->chiavi()[k]));
+    for (int i = 0; i < a->n; i++)
+        new (&b->chiavi()[b->n + 1 + i]) K(std::move(a->chiavi()[i]));
+    std::memcpy(&b->figli[b->n + 1], a->figli, sizeof(Nodo*) * (a->n + 1));
+    b->n += a->n + 1;
+    rimuoviDa(p->chiavi(), p->n, k);
+    rimuoviFiglio(p, k + 1);
+    p->n--;
+    delete a;
+}
+/**
+ * @brief Metodo che recupera l'elemento associato alla chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return elemento associato alla chiave.
+ */
+template <class K, class E, class C>
+typename BTree<K,E,C>::Element BTree<K,E,C>::recupera(const Key& key) const {
+    const Couple<K,E>* c = find(key);
+    if (c == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    return c->getElement();
+}
+/**
+ * @brief Metodo che aggiorna l'elemento associato alla chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia da aggiornare.
+ * @param element nuovo elemento.
+ */
+template <class K, class E, class C>
+void BTree<K,E,C>::aggiorna(const Key& key, const Element& element) {
+    Couple<K,E>* c = find(key);
+    if (c == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    c->setElement(element);
+}
+/**
+ * @brief Metodo che restituisce un puntatore alla coppia con chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia, nullptr se la chiave non è presente.
+ */
+template <class K, class E, class C>
+Couple<K,E>* BTree<K,E,C>::find(const Key& key) {
+    Foglia* f = discendi(key, nullptr, nullptr);
+    int pos = posizione(f, key);
+    return pos < f->n && !minore(key, f->coppie()[pos].getKey()) ? &f->coppie()[pos] : nullptr;
+}
+/**
+ * @brief Versione costante di find.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia, nullptr se la chiave non è presente.
+ */
+template <class K, class E, class C>
+const Couple<K,E>* BTree<K,E,C>::find(const Key& key) const {
+    return const_cast<BTree*>(this)->find(key);
+}
+/**
+ * @brief Metodo che recupera l'elemento associato a key senza sollevare eccezioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param element riceve una copia dell'elemento, se la chiave è presente.
+ * @return true se la chiave è presente, false altrimenti.
+ */
+template <class K, class E, class C>
+bool BTree<K,E,C>::tryGet(const Key& key, Element& element) const {
+    const Couple<K,E>* c = find(key);
+    if (c == nullptr)
+        return false;
+    element = c->getElement();
+    return true;
+}
+/**
+ * @brief Metodo che restituisce un iteratore alla prima coppia con chiave non minore di key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return iteratore alla coppia, end() se tutte le chiavi sono minori di key.
+ */
+template <class K, class E, class C>
+typename BTree<K,E,C>::iterator BTree<K,E,C>::lower_bound(const Key& key) {
+    Foglia* f = discendi(key, nullptr, nullptr);
+    return iterator(f, posizione(f, key));
+}
+/**
+ * @brief Versione costante di lower_bound.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return iteratore alla coppia, end() se tutte le chiavi sono minori di key.
+ */
+template <class K, class E, class C>
+typename BTree<K,E,C>::const_iterator BTree<K,E,C>::lower_bound(const Key& key) const {
+    return const_cast<BTree*>(this)->lower_bound(key);
+}
+/**
+ * @brief Metodo che restituisce un iteratore alla prima coppia con chiave maggiore di key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return iteratore alla coppia, end() se nessuna chiave è maggiore di key.
+ */
+template <class K, class E, class C>
+typename BTree<K,E,C>::iterator BTree<K,E,C>::upper_bound(const Key& key) {
+    Foglia* f = discendi(key, nullptr, nullptr);
+    int pos = posizione(f, key);
+    if (pos < f->n && !minore(key, f->coppie()[pos].getKey()))
+        pos++;
+    return iterator(f, pos);
+}
+/**
+ * @brief Versione costante di upper_bound.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return iteratore alla coppia, end() se nessuna chiave è maggiore di key.
+ */
+template <class K, class E, class C>
+typename BTree<K,E,C>::const_iterator BTree<K,E,C>::upper_bound(const Key& key) const {
+    return const_cast<BTree*>(this)->upper_bound(key);
+}
+/**
+ * @brief Metodo che restituisce le coppie con chiave in [da, a), in ordine crescente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param da chiave minima, inclusa.
+ * @param a chiave massima, esclusa.
+ * @return intervallo delle coppie, vuoto se a non è maggiore di da.
+ */
+template <class K, class E, class C>
+Intervallo<typename BTree<K,E,C>::const_iterator> BTree<K,E,C>::intervallo(const Key& da, const Key& a) const {
+    const_iterator inizio = lower_bound(da);
+    if (!minore(da, a))
+        return Intervallo<const_iterator>(inizio, inizio);
+    return Intervallo<const_iterator>(inizio, lower_bound(a));
+}
+/**
+ * @brief Metodo che restituisce le coppie la cui chiave inizia con p, in ordine crescente.
+ * Disponibile per chiavi stringa ordinate lessicograficamente (C di default): le
+ * chiavi cercate sono quelle in [p, q), dove q è p con l'ultimo carattere minore
+ * di 0xFF incrementato e i successivi rimossi.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param p prefisso.
+ * @return intervallo delle coppie con prefisso p.
+ */
+template <class K, class E, class C>
+Intervallo<typename BTree<K,E,C>::const_iterator> BTree<K,E,C>::prefisso(const Key& p) const {
+    Key q = p;
+    while (!q.empty() && static_cast<unsigned char>(q.back()) == 0xFF)
+        q.pop_back();
+    if (q.empty())
+        return Intervallo<const_iterator>(lower_bound(p), end());
+    q.back() = static_cast<char>(static_cast<unsigned char>(q.back()) + 1);
+    return Intervallo<const_iterator>(lower_bound(p), lower_bound(q));
+}
+/**
+ * @brief Metodo che svuota il dizionario, lasciando una sola foglia vuota.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class C>
+void BTree<K,E,C>::clear() {
+    Foglia* f = new Foglia();
+    libera(radice, 0);
+    radice = prima = f;
+    livelli = 0;
+    numCoppie = 0;
+}
+/**
+ * @brief Metodo che libera il sottoalbero di radice nodo.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param nodo radice del sottoalbero.
+ * @param livello profondità di nodo, 0 per la radice.
+ */
+template <class K, class E, class C>
+void BTree<K,E,C>::libera(Nodo* nodo, int livello) {
+    if (livello == livelli) {
+        delete static_cast<Foglia*>(nodo);
+        return;
+    }
+    Interno* x = static_cast<Interno*>(nodo);
+    for (int i = 0; i <= x->n; i++)
+        libera(x->figli[i], livello + 1);
+    delete x;
+}
+/**
+ * @brief Metodo che copia il sottoalbero di radice nodo, collegando le nuove foglie
+ * nell'ordine in cui vengono create.
+ * Se una copia solleva un'eccezione, i nodi del sottoalbero già copiati vengono
+ * liberati prima di propagarla.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param nodo radice del sottoalbero da copiare.
+ * @param livello profondità di nodo, 0 per la radice.
+ * @param ultima ultima foglia copiata, aggiornata.
+ * @return radice della copia.
+ */
+template <class K, class E, class C>
+typename BTree<K,E,C>::Nodo* BTree<K,E,C>::copia(const Nodo* nodo, int livello, Foglia*& ultima) {
+    if (livello == livelli) {
+        const Foglia* f = static_cast<const Foglia*>(nodo);
+        Foglia* g = new Foglia();
+        try {
+            for (; g->n < f->n; g->n++)
+                new (&g->coppie()[g->n]) Couple<K,E>(f->coppie()[g->n]);
+        } catch (...) {
+            delete g;
+            throw;
+        }
+        if (ultima == nullptr)
+            prima = g;
+        else
+            ultima->successiva = g;
+        ultima = g;
+        return g;
+    }
+    const Interno* x = static_cast<const Interno*>(nodo);
+    Interno* y = new Interno();
+    int i = 0;
+    try {
+        for (; y->n < x->n; y->n++)
+            new (&y->chiavi()[y->n]) K(x->chiavi()[y->n]);
+        for (; i <= x->n; i++)
+            y->figli[i] = copia(x->figli[i], livello + 1, ultima);
+    } catch (...) {
+        for (int j = 0; j < i; j++)
+            libera(y->figli[j], livello + 1);
+        delete y;
+        throw;
+    }
+    return y;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutte le chiavi del dizionario,
+ * in ordine crescente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutte le chiavi del dizionario.
+ */
+template <class K, class E, class C>
+VectorList<K> BTree<K,E,C>::keys() const {
+    VectorList<K> keys;
+    for (const Couple<K,E>& c : *this)
+        keys.inserisciCoda(c.getKey());
+    return keys;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutti gli elementi del dizionario,
+ * nell'ordine delle rispettive chiavi.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutti gli elementi del dizionario.
+ */
+template <class K, class E, class C>
+VectorList<E> BTree<K,E,C>::values() const {
+    VectorList<E> values;
+    for (const Couple<K,E>& c : *this)
+        values.inserisciCoda(c.getElement());
+    return values;
+}
+/**
+ * @brief Operatore di assegnamento.
+ * t viene copiato in un albero temporaneo, scambiato poi con questo: se la copia
+ * fallisce, il dizionario resta invariato.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param t dizionario da assegnare.
+ * @return riferimento al dizionario.
+ */
+template <class K, class E, class C>
+BTree<K,E,C>& BTree<K,E,C>::operator=(const BTree<K,E,C>& t) {
+    if (this != &t) {
+        BTree<K,E,C> temporaneo(t);
+        std::swap(radice, temporaneo.radice);
+        std::swap(prima, temporaneo.prima);
+        std::swap(livelli, temporaneo.livelli);
+        std::swap(numCoppie, temporaneo.numCoppie);
+        std::swap(minore, temporaneo.minore);
+    }
+    return *this;
+}
+/**
+ * @brief Operatore di uguaglianza.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param t dizionario da confrontare.
+ * @return true se i dizionari contengono le stesse chiavi, false altrimenti.
+ */
+template <class K, class E, class C>
+bool BTree<K,E,C>::operator==(const BTree<K,E,C>& t) const {
+    if (numCoppie != t.numCoppie)
+        return false;
+    for (const Couple<K,E>& c : *this) {
+        if (!t.appartiene(c.getKey()))
+            return false;
+    }
+    return true;
+}
+/**
+ * @brief Operatore di disuguaglianza.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param t dizionario da confrontare.
+ * @return true se i dizionari sono diversi, false altrimenti.
+ */
+template <class K, class E, class C>
+bool BTree<K,E,C>::operator!=(const BTree<K,E,C>& t) const {
+    return !(*this == t);
+}
+/**
+ * @brief Operatore di stream: stampa le coppie in ordine crescente di chiave.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param os stream di output.
+ * @param t dizionario da stampare.
+ * @return stream di output.
+ */
+template <class K, class E, class C>
+std::ostream& operator<<(std::ostream& os, const BTree<K,E,C>& t) {
+    os << "{";
+    bool primo = true;
+    for (const Couple<K,E>& c : t) {
+        if (!primo)
+            os << ", ";
+        os << c.getKey() << ": " << c.getElement();
+        primo = false;
+    }
+    os << "}";
+    return os;
+}
+
+#endif //DICTIONARY_BTREE_H
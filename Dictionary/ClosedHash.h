@@ -3,7 +3,54 @@
 
 #include "Dictionary.h"
 #include "Hash.h"
+#include "Statistiche.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+// Definendo CLOSEDHASH_STATISTICHE ogni ClosedHash conta ricerche riuscite e fallite,
+// ridimensionamenti e tempo speso nei ridimensionamenti (vedi statistiche()).
+#if defined(CLOSEDHASH_STATISTICHE)
+#include <atomic>
+#include <chrono>
+#endif
+
+/**
+ * @brief Politica di sondaggio utilizzata da ClosedHash.
+ * <ul>
+ * <li> LINEARE: sondaggio lineare, le cancellazioni lasciano bucket cancellati. </li>
+ * <li> ROBIN_HOOD: sondaggio lineare in cui una coppia lontana dal proprio bucket
+ * ideale prende il posto di quelle più vicine al proprio; le ricerche si fermano
+ * appena superano la distanza della coppia incontrata e le cancellazioni
+ * compattano la sequenza all'indietro, senza lasciare bucket cancellati. Se la
+ * funzione hash produce sequenze più lunghe della distanza rappresentabile anche
+ * in una tabella molto più grande del necessario, il dizionario passa al sondaggio lineare. </li>
+ * </ul>
+ */
+enum class Sondaggio { LINEARE, ROBIN_HOOD };
+
+/**
+ * @brief Modalità di ridimensionamento utilizzata da ClosedHash.
+ * <ul>
+ * <li> COMPLETO: quando la tabella è troppo piena tutte le coppie vengono trasferite
+ * nella nuova tabella durante l'inserimento che ne causa la crescita. </li>
+ * <li> INCREMENTALE: la vecchia tabella viene mantenuta accanto alla nuova e ogni
+ * operazione di modifica successiva ne trasferisce un numero limitato di coppie;
+ * le ricerche consultano entrambe le tabelle finché il trasferimento non termina.
+ * Nessuna singola operazione paga il costo dell'intera ricostruzione. </li>
+ * </ul>
+ */
+enum class Ridimensionamento { COMPLETO, INCREMENTALE };
 
 /**
  * @brief Classe che rappresenta un dizionario implementato con hash chiuso.
@@ -11,108 +58,361 @@
  * dimensione denominati bucket. Ognuno di questi contenitori può mantenere al
  * proprio interno al massimo una coppia < K, E >.
  * <br>
+ * Le coppie sono memorizzate direttamente all'interno di un unico array contiguo,
+ * affiancato da un array di byte di controllo che indica lo stato di ogni bucket:
+ * non viene effettuata alcuna allocazione per singola coppia e ogni passo di
+ * sondaggio accede a memoria contigua.
+ * <br>
  * Si utilizza un funzione aritmetica allo scopo di calcolare, partendo
  * dalla chiave, la posizione in tabella delle informazioni contenute nella coppia.
+ * Il numero di bucket è sempre una potenza di 2: il bucket ideale si ottiene dai
+ * bit alti del prodotto tra l'hash e una costante (hashing di Fibonacci) e il
+ * sondaggio avanza con una maschera di bit, senza divisioni intere.
+ * Le collisioni sono risolte secondo la politica di sondaggio scelta alla costruzione.
+ * <br>
+ * Oltre a inserisci(), che solleva un'eccezione se la chiave è già presente, sono
+ * disponibili emplace(), try_emplace() e insert_or_assign(), che costruiscono la
+ * coppia direttamente nel proprio bucket a partire dagli argomenti ricevuti.
+ * <br>
+ * Le coppie si possono visitare senza copiarle con un ciclo for sul dizionario o su
+ * entries(): ogni operazione di modifica invalida gli iteratori.
+ * <br>
+ * Con Ridimensionamento::INCREMENTALE la crescita della tabella viene distribuita
+ * sulle operazioni di modifica successive; durante il trasferimento le statistiche
+ * sui sondaggi si riferiscono alla sola tabella corrente.
+ * <br>
+ * statistiche() restituisce in una sola struttura, stampabile come testo o JSON,
+ * capacità, carico, bucket cancellati e istogramma dei sondaggi; compilando con
+ * CLOSEDHASH_STATISTICHE vengono aggiornati anche i contatori di ricerche e
+ * ridimensionamenti, altrimenti assenti e senza alcun costo.
+ * <br>
+ * Le coppie e i byte di controllo di ogni tabella occupano due soli blocchi di
+ * memoria, ottenuti dall'allocatore A: con un AllocatoreArena (vedi Arena.h) più
+ * dizionari possono prelevarli da un'unica arena e rilasciarli tutti insieme.
+ * Se le coppie sono banalmente distruttibili, clear() e la distruzione non visitano
+ * i bucket.
  * @tparam K tipo della chiave.
  * @tparam E tipo dell'elemento.
+ * @tparam H funzione hash, per default Hash<K>.
+ * @tparam A allocatore delle coppie, per default std::allocator.
  */
-template <class K, class E>
+template <class K, class E, class H = Hash<K>, class A = std::allocator<Couple<K,E>>>
 class ClosedHash : public Dictionary<K,E> {
 public:
     typedef typename Dictionary<K,E>::Key Key;
     typedef typename Dictionary<K,E>::Element Element;
 
+    /**
+     * @brief Iteratore in avanti sulle coppie del dizionario, comprese quelle della
+     * tabella in corso di trasferimento.
+     * @tparam Costante true per un iteratore che non consente di modificare le coppie.
+     */
+    template <bool Costante>
+    class Iteratore {
+        typedef typename std::conditional<Costante, const ClosedHash, ClosedHash>::type Tabella;
+        typedef typename std::conditional<Costante, const Couple<K,E>, Couple<K,E>>::type Voce;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Couple<K,E> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Voce* pointer;
+        typedef Voce& reference;
+
+        Iteratore() : d(nullptr), i(0) {}
+        Iteratore(const Iteratore<false>& it) : d(it.d), i(it.i) {}
+
+        reference operator*() const {return *d->coppia(i);}
+        pointer operator->() const {return d->coppia(i);}
+        Iteratore& operator++() {
+            i = d->prossimo(i + 1);
+            return *this;
+        }
+        Iteratore operator++(int) {
+            Iteratore it = *this;
+            ++*this;
+            return it;
+        }
+        bool operator==(const Iteratore& it) const {return i == it.i;}
+        bool operator!=(const Iteratore& it) const {return i != it.i;}
+
+    private:
+        friend class ClosedHash;
+        template <bool> friend class Iteratore;
+        Iteratore(Tabella* d, int i) : d(d), i(i) {}
+
+        Tabella* d;
+        int i;          // bucket corrente; oltre maxBuckets, bucket della vecchia tabella
+    };
+    typedef Iteratore<false> iterator;
+    typedef Iteratore<true> const_iterator;
+
     ClosedHash();
     ClosedHash(int);
+    ClosedHash(int, Sondaggio, Ridimensionamento = Ridimensionamento::COMPLETO, const A& = A());
+    template<class It, class = typename std::iterator_traits<It>::iterator_category>
+    ClosedHash(It, It, Sondaggio = Sondaggio::LINEARE);
     ClosedHash(const ClosedHash&);
     ~ClosedHash();
 
     bool dizionarioVuoto() const;
-    void inserisci(Couple<Key,Element>&);
+    void inserisci(const Couple<Key,Element>&);
+    void inserisci(Couple<Key,Element>&&);
+    template<class It, class = typename std::iterator_traits<It>::iterator_category>
+    void inserisci(It, It);
     void cancella(const Key&);
     Element recupera(const Key&) const;
     bool appartiene(const Key&) const;
     void aggiorna(const Key&, const Element&);
 
+    Couple<K,E>* find(const Key&);
+    const Couple<K,E>* find(const Key&) const;
+    bool tryGet(const Key&, Element&) const;
+
+    // Ricerche con chiavi equivalenti a Key (per esempio string_view per Key = string)
+    template<class Q, class = ChiaveTrasparente<H,Q,K>>
+    void cancella(const Q&);
+    template<class Q, class = ChiaveTrasparente<H,Q,K>>
+    Element recupera(const Q&) const;
+    template<class Q, class = ChiaveTrasparente<H,Q,K>>
+    bool appartiene(const Q&) const;
+    template<class Q, class = ChiaveTrasparente<H,Q,K>>
+    Couple<K,E>* find(const Q&);
+    template<class Q, class = ChiaveTrasparente<H,Q,K>>
+    const Couple<K,E>* find(const Q&) const;
+    template<class Q, class = ChiaveTrasparente<H,Q,K>>
+    bool tryGet(const Q&, Element&) const;
+    template<class Q, class = ChiaveTrasparente<H,Q,K>>
+    int recuperaMolti(const Q*, int, Element*, uint64_t*) const;
+
+    template<class... Args>
+    std::pair<Couple<K,E>*, bool> emplace(Args&&...);
+    template<class... Args>
+    std::pair<Couple<K,E>*, bool> try_emplace(const Key&, Args&&...);
+    template<class... Args>
+    std::pair<Couple<K,E>*, bool> try_emplace(Key&&, Args&&...);
+    template<class E1>
+    std::pair<Couple<K,E>*, bool> insert_or_assign(const Key&, E1&&);
+    template<class E1>
+    std::pair<Couple<K,E>*, bool> insert_or_assign(Key&&, E1&&);
+
     void clear();
-    int lunghezza() const {return bucketsUsed;}
+    void reserve(int);
+    void riorganizza();
+    int lunghezza() const {return bucketsUsed + vecchiUsati;}
+    int cancellati() const {return bucketsDeleted;}
+    Sondaggio getSondaggio() const {return politica;}
+    Ridimensionamento getRidimensionamento() const {return ridimensionamento;}
+    A getAllocatore() const {return allocatore;}
+    bool trasferimentoInCorso() const {return vecchiBuckets != nullptr;}
+
+    int sondaggioMassimo() const;
+    double sondaggioMedio() const;
+    VectorList<int> istogrammaSondaggi() const;
+    StatisticheHash statistiche() const;
     VectorList<K> keys() const;
     VectorList<E> values() const;
 
-    ClosedHash<K,E>& operator=(const ClosedHash<K,E>&);
-    bool operator==(const ClosedHash<K,E>&) const;
-    bool operator!=(const ClosedHash<K,E>&) const;
+    iterator begin() {return iterator(this, prossimo(0));}
+    iterator end() {return iterator(this, fine());}
+    const_iterator begin() const {return const_iterator(this, prossimo(0));}
+    const_iterator end() const {return const_iterator(this, fine());}
+    Intervallo<iterator> entries() {return Intervallo<iterator>(begin(), end());}
+    Intervallo<const_iterator> entries() const {return Intervallo<const_iterator>(begin(), end());}
 
-    template<class K1, class E1>
-    friend std::ostream& operator<<(std::ostream&, const ClosedHash<K1,E1>&);
+    ClosedHash<K,E,H,A>& operator=(const ClosedHash<K,E,H,A>&);
+    bool operator==(const ClosedHash<K,E,H,A>&) const;
+    bool operator!=(const ClosedHash<K,E,H,A>&) const;
+
+    template<class K1, class E1, class H1, class A1>
+    friend std::ostream& operator<<(std::ostream&, const ClosedHash<K1,E1,H1,A1>&);
 
 private:
+    static const unsigned char VUOTO = 0;       // bucket mai occupato
+    static const unsigned char CANCELLATO = 1;  // bucket liberato da una cancellazione
+    static const unsigned char DA_SPOSTARE = 2; // coppia in attesa di riposizionamento (solo in riorganizza)
+    static const unsigned char OCCUPATO = 3;    // bucket che contiene una coppia (Robin Hood: + distanza)
+    static const int DISTANZA_MAX = 255 - OCCUPATO;
+    static const int PASSO_TRASFERIMENTO = 16;  // coppie trasferite per operazione (INCREMENTALE)
+    static const int BLOCCO_RICERCHE = 32;      // chiavi precaricate insieme da recuperaMolti
+
+    static const bool DISTRUZIONE_BANALE = std::is_trivially_destructible<Couple<K,E>>::value;
+
+    typedef std::allocator_traits<A> TrattiCoppie;
+    typedef typename TrattiCoppie::template rebind_alloc<unsigned char> AllocatoreStato;
+    typedef std::allocator_traits<AllocatoreStato> TrattiStato;
+
+    static void precarica(const void*);
+
+    /**
+     * @brief Misura la durata di un ridimensionamento; con più ridimensionamenti
+     * annidati conta solo il più esterno. Senza CLOSEDHASH_STATISTICHE non fa nulla.
+     */
+    class Cronometro {
+    public:
+        Cronometro(const ClosedHash*, bool);
+        ~Cronometro();
+
+#if defined(CLOSEDHASH_STATISTICHE)
+    private:
+        const ClosedHash* d;
+        bool esterno;
+        std::chrono::steady_clock::time_point inizio;
+#endif
+    };
+    void contaRicerca(bool) const;
+
+    void allocaTabella(int, Couple<K,E>*&, unsigned char*&);
+    void rilasciaTabella(Couple<K,E>*, unsigned char*, int);
+    void distruggiTabella(Couple<K,E>*, unsigned char*, int);
+    void copiaTabella(const Couple<K,E>*, const unsigned char*, int, Couple<K,E>*&, unsigned char*&);
+    void allocaBuckets(int);
+    void liberaBuckets();
+    void copiaBuckets(const ClosedHash<K,E,H,A>&);
     void changeMaxBuckets(int);
+    void liberaSpazio();
+    void ingrandisci(int);
+    void avviaTrasferimento(int);
+    void passoTrasferimento();
+    int trasferisci(int);
+    void liberaVecchi();
+    template<class... Args>
+    std::pair<int, bool> inserisciSeAssente(const Key&, Args&&...);
+    int posiziona(Couple<K,E>&&);
+    void preparaRobinHood(const Key&);
+    bool verificaRobinHood(int) const;
+    int posizionaRobinHood(Couple<K,E>&&);
+    void passaALineare();
+    template<class Q>
+    int calcHome(const Q&) const;
+    template<class Q>
+    int calcHome(const Q&, int) const;
     int calcPosition(const Key&) const;
-    Couple <K,E>** buckets;
+    template<class Q>
+    int cercaSlot(const Q&) const;
+    template<class Q>
+    int cercaSlot(const Q&, const unsigned char*, const Couple<K,E>*, int) const;
+    template<class Q>
+    int cercaSlot(const Q&, int, const unsigned char*, const Couple<K,E>*, int) const;
+    template<class Q>
+    Couple<K,E>* cercaCoppia(const Q&) const;
+    int distanza(int) const;
+    int fine() const {return maxBuckets + (vecchiBuckets != nullptr ? vecchiaDim : 0);}
+    int prossimo(int) const;
+    Couple<K,E>* coppia(int i) const {return i < maxBuckets ? &buckets[i] : &vecchiBuckets[i - maxBuckets];}
+    Couple<K,E>* buckets;   // coppie memorizzate in linea
+    unsigned char* stato;   // byte di controllo, uno per bucket
     int bucketsUsed;        // numeri Elementi
-    int maxBuckets;         // divisore
-    Hash<K> hash;
+    int bucketsDeleted;     // bucket marcati come cancellati
+    int maxBuckets;         // numero di bucket, potenza di 2
+    int bitIndice;          // log2(maxBuckets)
+    Sondaggio politica;
+    Ridimensionamento ridimensionamento;
+    Couple<K,E>* vecchiBuckets;     // tabella in corso di trasferimento, nullptr se assente
+    unsigned char* vecchioStato;
+    int vecchiaDim;
+    int vecchioBitIndice;
+    int vecchiUsati;                // coppie ancora da trasferire
+    int cursore;                    // primo bucket della vecchia tabella non ancora visitato
+#if defined(CLOSEDHASH_STATISTICHE)
+    struct Contatori {
+        std::atomic<uint64_t> riuscite{0};      // atomici: più lettori possono cercare insieme
+        std::atomic<uint64_t> fallite{0};
+        uint64_t ridimensionamenti = 0;
+        std::chrono::steady_clock::duration tempo{0};
+        int annidamento = 0;
+    };
+    mutable Contatori contatori;    // non copiati: una copia riparte da zero
+#endif
+    H hash;
+    A allocatore;
 };
 /**
- * @brief Costruttore di default che inizializza un dizionario con 20 bucket.
+ * @brief Costruttore di default che inizializza un dizionario con 32 bucket.
  * @tparam K tipo della chiave.
  * @tparam E tipo dell'elemento.
  */
-template<class K, class E>
-ClosedHash<K,E>::ClosedHash() {
-    maxBuckets = 20;
+template<class K, class E, class H, class A>
+ClosedHash<K,E,H,A>::ClosedHash() {
+    politica = Sondaggio::LINEARE;
+    ridimensionamento = Ridimensionamento::COMPLETO;
+    vecchiBuckets = nullptr;
+    vecchiUsati = 0;
     bucketsUsed = 0;
-    buckets = new Couple<K,E>*[maxBuckets];
-    for(int i = 0; i < maxBuckets; i++)
-        buckets[i] = nullptr;
+    bucketsDeleted = 0;
+    allocaBuckets(32);
 }
 /**
- * @brief Costruttore che inizializza un dizionario con un numero di bucket pari a maxBuckets.
+ * @brief Costruttore che inizializza un dizionario con un numero di bucket pari alla
+ * potenza di 2 maggiore o uguale a maxBuckets (almeno 8).
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param maxBuckets numero di bucket.
+ */
+template<class K, class E, class H, class A>
+ClosedHash<K,E,H,A>::ClosedHash(int maxBuckets) : ClosedHash(maxBuckets, Sondaggio::LINEARE) {}
+/**
+ * @brief Costruttore che inizializza un dizionario con almeno maxBuckets bucket, la
+ * politica di sondaggio, la modalità di ridimensionamento e l'allocatore indicati.
  * @tparam K tipo della chiave.
  * @tparam E tipo dell'elemento.
  * @param maxBuckets numero di bucket.
+ * @param politica politica di sondaggio.
+ * @param ridimensionamento modalità di ridimensionamento.
+ * @param allocatore allocatore delle tabelle.
  */
-template<class K, class E>
-ClosedHash<K,E>::ClosedHash(int maxBuckets) {
-    this->maxBuckets = maxBuckets;
+template<class K, class E, class H, class A>
+ClosedHash<K,E,H,A>::ClosedHash(int maxBuckets, Sondaggio politica, Ridimensionamento ridimensionamento,
+                                const A& allocatore) : allocatore(allocatore) {
+    if (maxBuckets <= 0)
+        throw std::invalid_argument("Error: il numero di bucket deve essere positivo.");
+    this->politica = politica;
+    this->ridimensionamento = ridimensionamento;
+    vecchiBuckets = nullptr;
+    vecchiUsati = 0;
     bucketsUsed = 0;
-    buckets = new Couple<K,E>*[maxBuckets];
-    for(int i = 0; i < maxBuckets; i++)
-        buckets[i] = nullptr;
+    bucketsDeleted = 0;
+    int dim = 8;
+    while (dim < maxBuckets)
+        dim *= 2;
+    allocaBuckets(dim);
+}
+/**
+ * @brief Costruttore che inizializza un dizionario con le coppie dell'intervallo
+ * [first, last), dimensionando la tabella una sola volta (vedi inserisci(It, It)).
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam It iteratore (almeno forward) su coppie Couple<K, E>; con un
+ * std::move_iterator le coppie vengono spostate.
+ * @param first inizio dell'intervallo.
+ * @param last fine dell'intervallo.
+ * @param politica politica di sondaggio.
+ */
+template<class K, class E, class H, class A>
+template<class It, class>
+ClosedHash<K,E,H,A>::ClosedHash(It first, It last, Sondaggio politica) : ClosedHash(8, politica) {
+    inserisci(first, last);
 }
 /**
  * @brief Costruttore di copia.
+ * La copia ottiene l'allocatore da select_on_container_copy_construction().
  * @tparam K tipo della chiave.
  * @tparam E tipo dell'elemento.
  * @param h dizionario da copiare.
  */
-template<class K, class E>
-ClosedHash<K,E>::ClosedHash(const ClosedHash& h) {
-    maxBuckets = h.maxBuckets;
-    bucketsUsed = h.bucketsUsed;
-    buckets = new Couple<K,E>*[maxBuckets];
-    for(int i = 0; i < maxBuckets; i++) {
-        if (h.buckets[i] == nullptr) {
-            buckets[i] = nullptr;
-        }
-        else {
-            Couple<K,E> couple(h.buckets[i]->getKey(), h.buckets[i]->getElement());
-            buckets[i] = new Couple<Key, Element>(couple);
-        }
-    }
+template<class K, class E, class H, class A>
+ClosedHash<K,E,H,A>::ClosedHash(const ClosedHash& h)
+        : allocatore(TrattiCoppie::select_on_container_copy_construction(h.allocatore)) {
+    copiaBuckets(h);
 }
 /**
  * @brief Distruttore.
  * @tparam K tipo della chiave.
  * @tparam E tipo dell'elemento.
  */
-template<class K, class E>
-ClosedHash<K,E>::~ClosedHash() {
-    for(int i = 0; i < maxBuckets; i++) {
-        delete buckets[i];
-    }
-    delete[] buckets;
+template<class K, class E, class H, class A>
+ClosedHash<K,E,H,A>::~ClosedHash() {
+    liberaBuckets();
 }
 /**
  * @brief Metodo che controlla se il dizionario è vuoto.
@@ -120,72 +420,234 @@ ClosedHash<K,E>::~ClosedHash() {
  * @tparam E tipo dell'elemento.
  * @return true se il dizionario è vuoto, false altrimenti.
  */
-template<class K, class E>
-bool ClosedHash<K,E>::dizionarioVuoto() const {
-    return bucketsUsed == 0;
+template<class K, class E, class H, class A>
+bool ClosedHash<K,E,H,A>::dizionarioVuoto() const {
+    return lunghezza() == 0;
 }
 /**
  * @brief Metodo che inserisce una coppia < K, E > nel dizionario.
+ * Con sondaggio lineare la coppia occupa il primo bucket cancellato incontrato
+ * lungo la sequenza di sondaggio, oppure il bucket vuoto in cui la sequenza termina.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param couple coppia da copiare nel dizionario.
+ */
+template<class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::inserisci(const Couple<Key,Element>& couple) {
+    if (!inserisciSeAssente(couple.getKey(), couple).second)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+}
+/**
+ * @brief Metodo che inserisce una coppia < K, E > nel dizionario spostandola.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param couple coppia da spostare nel dizionario; non viene modificata se la
+ * chiave è già presente.
+ */
+template<class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::inserisci(Couple<Key,Element>&& couple) {
+    if (!inserisciSeAssente(couple.getKey(), std::move(couple)).second)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+}
+/**
+ * @brief Metodo che costruisce una coppia con gli argomenti args e la inserisce
+ * se la sua chiave non è già presente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param args argomenti del costruttore di Couple<K, E>.
+ * @return puntatore alla coppia con la chiave indicata e true se è stata inserita,
+ * false se era già presente (in tal caso il dizionario non viene modificato).
+ */
+template<class K, class E, class H, class A>
+template<class... Args>
+std::pair<Couple<K,E>*, bool> ClosedHash<K,E,H,A>::emplace(Args&&... args) {
+    Couple<K,E> c(std::forward<Args>(args)...);
+    std::pair<int, bool> r = inserisciSeAssente(c.getKey(), std::move(c));
+    return {&buckets[r.first], r.second};
+}
+/**
+ * @brief Metodo che inserisce una coppia con chiave key ed elemento costruito con
+ * gli argomenti args, solo se la chiave non è già presente.
+ * Se la chiave è presente gli argomenti non vengono utilizzati.
  * @tparam K tipo della chiave.
  * @tparam E tipo dell'elemento.
  * @param key chiave.
- * @param element elemento.
+ * @param args argomenti del costruttore dell'elemento.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita, false altrimenti.
  */
-template<class K, class E>
-void ClosedHash<K,E>::inserisci(Couple<Key,Element>& couple) {
-    // Se il numero di bucket occupati è maggiore o uguale al 75% del numero di bucket
-    if ((double)bucketsUsed >= (double)maxBuckets * 0.75) {
-        changeMaxBuckets(maxBuckets * 2);
-        maxBuckets *= 2;
+template<class K, class E, class H, class A>
+template<class... Args>
+std::pair<Couple<K,E>*, bool> ClosedHash<K,E,H,A>::try_emplace(const Key& key, Args&&... args) {
+    std::pair<int, bool> r = inserisciSeAssente(key, std::piecewise_construct, key, std::forward<Args>(args)...);
+    return {&buckets[r.first], r.second};
+}
+/**
+ * @brief Versione di try_emplace che sposta la chiave nella coppia inserita.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave, spostata solo se la coppia viene inserita.
+ * @param args argomenti del costruttore dell'elemento.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita, false altrimenti.
+ */
+template<class K, class E, class H, class A>
+template<class... Args>
+std::pair<Couple<K,E>*, bool> ClosedHash<K,E,H,A>::try_emplace(Key&& key, Args&&... args) {
+    std::pair<int, bool> r = inserisciSeAssente(key, std::piecewise_construct, std::move(key), std::forward<Args>(args)...);
+    return {&buckets[r.first], r.second};
+}
+/**
+ * @brief Metodo che inserisce la coppia < key, element > oppure, se la chiave è già
+ * presente, le assegna element.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param element elemento da inserire o assegnare.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita, false se
+ * è stata aggiornata.
+ */
+template<class K, class E, class H, class A>
+template<class E1>
+std::pair<Couple<K,E>*, bool> ClosedHash<K,E,H,A>::insert_or_assign(const Key& key, E1&& element) {
+    std::pair<int, bool> r = inserisciSeAssente(key, std::piecewise_construct, key, std::forward<E1>(element));
+    if (!r.second)
+        buckets[r.first].getElement() = std::forward<E1>(element);
+    return {&buckets[r.first], r.second};
+}
+/**
+ * @brief Versione di insert_or_assign che sposta la chiave nella coppia inserita.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave, spostata solo se la coppia viene inserita.
+ * @param element elemento da inserire o assegnare.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita, false se
+ * è stata aggiornata.
+ */
+template<class K, class E, class H, class A>
+template<class E1>
+std::pair<Couple<K,E>*, bool> ClosedHash<K,E,H,A>::insert_or_assign(Key&& key, E1&& element) {
+    std::pair<int, bool> r = inserisciSeAssente(key, std::piecewise_construct, std::move(key), std::forward<E1>(element));
+    if (!r.second)
+        buckets[r.first].getElement() = std::forward<E1>(element);
+    return {&buckets[r.first], r.second};
+}
+/**
+ * @brief Metodo che inserisce tutte le coppie dell'intervallo [first, last).
+ * La tabella viene dimensionata una sola volta per l'intero intervallo e le coppie
+ * vengono inserite in ordine di bucket ideale (ordinamento per conteggio, in tempo
+ * lineare): ogni inserimento prosegue la scansione di memoria contigua del precedente
+ * e, con Robin Hood, non sposta le coppie già inserite.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam It iteratore (almeno forward) su coppie Couple<K, E>; con un
+ * std::move_iterator le coppie vengono spostate.
+ * @param first inizio dell'intervallo.
+ * @param last fine dell'intervallo.
+ * @throws std::runtime_error se una chiave è già presente; le coppie che la
+ * precedono nell'ordine di inserimento restano nel dizionario.
+ */
+template<class K, class E, class H, class A>
+template<class It, class>
+void ClosedHash<K,E,H,A>::inserisci(It first, It last) {
+    std::vector<It> coppie;
+    for (It it = first; it != last; ++it)
+        coppie.push_back(it);
+    int n = static_cast<int>(coppie.size());
+    if (n == 0)
+        return;
+    reserve(lunghezza() + n);
+
+    // Le coppie vengono raggruppate secondo i bit alti del bucket ideale, in un
+    // numero di gruppi proporzionale a n e non superiore al numero di bucket
+    int bitGruppi = 0;
+    while ((1 << bitGruppi) < n && bitGruppi < bitIndice)
+        bitGruppi++;
+    int scarto = bitIndice - bitGruppi;
+    std::vector<int> gruppo(n);
+    std::vector<int> inizio((1 << bitGruppi) + 1, 0);
+    for (int i = 0; i < n; i++) {
+        gruppo[i] = calcHome((*coppie[i]).getKey()) >> scarto;
+        inizio[gruppo[i] + 1]++;
     }
-    // Individua l'indice del bucket in cui inserire la coppia
-    int i = calcPosition(couple.getKey());
-    int j = i;
-    bool inserted = false;
-    do {
-        if (buckets[j] == nullptr) {
-            // Se il bucket è vuoto inserisce la coppia
-            buckets[j] = new Couple<K, E>(couple);
-            bucketsUsed++;
-            inserted = true;
-        } else if (buckets[j]->getKey() == couple.getKey()) {
-            throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
-        }
-        j = (j + 1) % maxBuckets;  // Probing lineare
-    } while (j != i && !inserted);
+    for (int g = 0; g < (1 << bitGruppi); g++)
+        inizio[g + 1] += inizio[g];
+    std::vector<int> ordine(n);
+    for (int i = 0; i < n; i++)
+        ordine[inizio[gruppo[i]]++] = i;
 
-    if (!inserted) {
-        throw std::runtime_error("Error: impossibile inserire la coppia");
+    for (int i = 0; i < n; i++) {
+        It& it = coppie[ordine[i]];
+        if (!inserisciSeAssente((*it).getKey(), *it).second)
+            throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
     }
 }
 /**
  * @brief Metodo che rimuove una coppia < K, E > dal dizionario.
+ * Il bucket liberato viene marcato come cancellato, in modo da non interrompere
+ * la sequenza di sondaggio delle chiavi inserite dopo di essa. Se il bucket
+ * successivo è vuoto, nessuna sequenza passa per il bucket liberato, che può
+ * quindi tornare vuoto. Con Robin Hood le coppie successive vengono invece
+ * spostate indietro finché non si incontra una coppia nel proprio bucket ideale.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ */
+template<class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::cancella(const Key& key) {
+    cancella<Key>(key);
+}
+/**
+ * @brief Versione di cancella con una chiave di tipo equivalente a Key.
  * @tparam K tipo della chiave.
  * @tparam E tipo dell'elemento.
+ * @tparam Q tipo della chiave cercata, confrontabile con K.
  * @param key chiave.
  */
-template<class K, class E>
-void ClosedHash<K,E>::cancella(const Key& key) {
-    if (!dizionarioVuoto()) {
-        if (appartiene(key)) {
-            int i = hash(key) % maxBuckets;
-            int j = i;
-            bool removed = false;
-            do {
-                if (buckets[j] != nullptr && buckets[j]->getKey() == key) {
-                    delete buckets[j];
-                    buckets[j] = nullptr;
-                    bucketsUsed--;
-                    removed = true;
-                }
-                j = (j + 1) % maxBuckets;
-            } while (j != i && !removed);
-        } else {
+template<class K, class E, class H, class A>
+template<class Q, class>
+void ClosedHash<K,E,H,A>::cancella(const Q& key) {
+    if (dizionarioVuoto())
+        throw std::out_of_range("Il dizionario è vuoto.");
+
+    int i = cercaSlot(key);
+    if (i == -1) {
+        // La coppia può trovarsi ancora nella tabella in corso di trasferimento
+        int j = vecchiBuckets != nullptr ? cercaSlot(key, vecchioStato, vecchiBuckets, vecchioBitIndice) : -1;
+        if (j == -1)
             throw std::out_of_range("Error: la chiave non e' presente.");
+        vecchiBuckets[j].~Couple<K,E>();
+        vecchioStato[j] = CANCELLATO;
+        vecchiUsati--;
+        passoTrasferimento();
+        return;
+    }
+
+    buckets[i].~Couple<K,E>();
+    bucketsUsed--;
+    if (politica == Sondaggio::ROBIN_HOOD) {
+        // Le coppie successive che non si trovano nel proprio bucket ideale
+        // vengono spostate indietro di una posizione
+        int j = (i + 1) & (maxBuckets - 1);
+        while (stato[j] > OCCUPATO) {
+            new (&buckets[i]) Couple<K,E>(std::move(buckets[j]));
+            buckets[j].~Couple<K,E>();
+            stato[i] = stato[j] - 1;
+            i = j;
+            j = (j + 1) & (maxBuckets - 1);
+        }
+        stato[i] = VUOTO;
+    } else if (stato[(i + 1) & (maxBuckets - 1)] == VUOTO) {
+        // Nessuna sequenza di sondaggio prosegue oltre i: il bucket torna vuoto,
+        // insieme ai bucket cancellati che lo precedono.
+        stato[i] = VUOTO;
+        for (int j = (i - 1) & (maxBuckets - 1); stato[j] == CANCELLATO; j = (j - 1) & (maxBuckets - 1)) {
+            stato[j] = VUOTO;
+            bucketsDeleted--;
         }
     } else {
-        throw std::out_of_range("Il dizionario è vuoto.");
+        stato[i] = CANCELLATO;
+        bucketsDeleted++;
     }
+    passoTrasferimento();
 }
 /**
  * @brief Metodo che restituisce l'elemento associato alla chiave key.
@@ -194,23 +656,28 @@ void ClosedHash<K,E>::cancella(const Key& key) {
  * @param key chiave.
  * @return elemento associato alla chiave key.
  */
-template<class K, class E>
-typename ClosedHash<K,E>::Element ClosedHash<K,E>::recupera(const ClosedHash::Key& key) const {
-    if (!dizionarioVuoto()) {
-        if (appartiene(key)) {
-            int i = hash(key) % maxBuckets;
-            int j = i;
-            do {
-                if (buckets[j] != nullptr && buckets[j]->getKey() == key)
-                    return buckets[j]->getElement();
-                j = (j + 1) % maxBuckets;
-            } while (j != i);
-        } else {
-            throw std::out_of_range("Error: la chiave non e' presente.");
-        }
-    } else {
+template<class K, class E, class H, class A>
+typename ClosedHash<K,E,H,A>::Element ClosedHash<K,E,H,A>::recupera(const ClosedHash::Key& key) const {
+    return recupera<Key>(key);
+}
+/**
+ * @brief Versione di recupera con una chiave di tipo equivalente a Key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam Q tipo della chiave cercata, confrontabile con K.
+ * @param key chiave.
+ * @return elemento associato alla chiave key.
+ */
+template<class K, class E, class H, class A>
+template<class Q, class>
+typename ClosedHash<K,E,H,A>::Element ClosedHash<K,E,H,A>::recupera(const Q& key) const {
+    if (dizionarioVuoto())
         throw std::out_of_range("Il dizionario è vuoto.");
-    }
+
+    const Couple<K,E>* c = cercaCoppia(key);
+    if (c == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    return c->getElement();
 }
 /**
  * @brief Metodo che verifica se il dizionario contiene una coppia con chiave key.
@@ -219,16 +686,22 @@ typename ClosedHash<K,E>::Element ClosedHash<K,E>::recupera(const ClosedHash::Ke
  * @param key chiave.
  * @return true se il dizionario contiene una coppia con chiave key, false altrimenti.
  */
-template<class K, class E>
-bool ClosedHash<K,E>::appartiene(const Key& key) const {
-    int i = hash(key) % maxBuckets;
-    int j = i;
-    do {
-        if (buckets[j] != nullptr && buckets[j]->getKey() == key)
-            return true;
-        j = (j + 1) % maxBuckets;
-    } while (j != i);
-    return false;
+template<class K, class E, class H, class A>
+bool ClosedHash<K,E,H,A>::appartiene(const Key& key) const {
+    return cercaCoppia(key) != nullptr;
+}
+/**
+ * @brief Versione di appartiene con una chiave di tipo equivalente a Key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam Q tipo della chiave cercata, confrontabile con K.
+ * @param key chiave.
+ * @return true se il dizionario contiene una coppia con chiave key, false altrimenti.
+ */
+template<class K, class E, class H, class A>
+template<class Q, class>
+bool ClosedHash<K,E,H,A>::appartiene(const Q& key) const {
+    return cercaCoppia(key) != nullptr;
 }
 /**
  * @brief Metodo che aggiorna il valore associato a una chiave esistente.
@@ -237,36 +710,184 @@ bool ClosedHash<K,E>::appartiene(const Key& key) const {
  * @param key chiave.
  * @param element nuovo elemento.
  */
-template<class K, class E>
-void ClosedHash<K,E>::aggiorna(const Key& key, const Element& element) {
-    if (!dizionarioVuoto()) {
-        if (appartiene(key)) {
-            int i = hash(key) % maxBuckets;
-            int j = i;
-            do {
-                if (buckets[j] != nullptr && buckets[j]->getKey() == key)
-                    buckets[j]->setElement(element);
-                j = (j + 1) % maxBuckets;
-            } while (j != i);
-        } else {
-            throw std::out_of_range("Error: la chiave non e' presente.");
-        }
-    } else {
+template<class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::aggiorna(const Key& key, const Element& element) {
+    if (dizionarioVuoto())
         throw std::out_of_range("Il dizionario è vuoto.");
+
+    Couple<K,E>* c = cercaCoppia(key);
+    if (c == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    c->setElement(element);
+    passoTrasferimento();
+}
+/**
+ * @brief Metodo che cerca la coppia con chiave key senza sollevare eccezioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia con chiave key, nullptr se la chiave non è presente.
+ */
+template<class K, class E, class H, class A>
+Couple<K,E>* ClosedHash<K,E,H,A>::find(const Key& key) {
+    return cercaCoppia(key);
+}
+/**
+ * @brief Versione costante di find.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia con chiave key, nullptr se la chiave non è presente.
+ */
+template<class K, class E, class H, class A>
+const Couple<K,E>* ClosedHash<K,E,H,A>::find(const Key& key) const {
+    return cercaCoppia(key);
+}
+/**
+ * @brief Versione di find con una chiave di tipo equivalente a Key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam Q tipo della chiave cercata, confrontabile con K.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia con chiave key, nullptr se la chiave non è presente.
+ */
+template<class K, class E, class H, class A>
+template<class Q, class>
+Couple<K,E>* ClosedHash<K,E,H,A>::find(const Q& key) {
+    return cercaCoppia(key);
+}
+/**
+ * @brief Versione costante di find con una chiave di tipo equivalente a Key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam Q tipo della chiave cercata, confrontabile con K.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia con chiave key, nullptr se la chiave non è presente.
+ */
+template<class K, class E, class H, class A>
+template<class Q, class>
+const Couple<K,E>* ClosedHash<K,E,H,A>::find(const Q& key) const {
+    return cercaCoppia(key);
+}
+/**
+ * @brief Metodo che recupera l'elemento associato a key senza sollevare eccezioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param element parametro di uscita in cui copiare l'elemento trovato.
+ * @return true se la chiave è presente, false altrimenti (element non viene modificato).
+ */
+template<class K, class E, class H, class A>
+bool ClosedHash<K,E,H,A>::tryGet(const Key& key, Element& element) const {
+    return tryGet<Key>(key, element);
+}
+/**
+ * @brief Versione di tryGet con una chiave di tipo equivalente a Key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam Q tipo della chiave cercata, confrontabile con K.
+ * @param key chiave da cercare.
+ * @param element parametro di uscita in cui copiare l'elemento trovato.
+ * @return true se la chiave è presente, false altrimenti (element non viene modificato).
+ */
+template<class K, class E, class H, class A>
+template<class Q, class>
+bool ClosedHash<K,E,H,A>::tryGet(const Q& key, Element& element) const {
+    const Couple<K,E>* c = cercaCoppia(key);
+    if (c == nullptr)
+        return false;
+    element = c->getElement();
+    return true;
+}
+/**
+ * @brief Metodo che recupera gli elementi associati a n chiavi con un'unica chiamata.
+ * Le chiavi vengono elaborate a blocchi di BLOCCO_RICERCHE: per ogni blocco si
+ * calcolano prima tutti i bucket ideali, richiedendo alla cache il byte di controllo
+ * e la coppia di ciascuno, e solo dopo si eseguono i sondaggi. Così i caricamenti
+ * dalla memoria delle diverse chiavi si sovrappongono invece di essere attesi uno
+ * alla volta.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam Q tipo delle chiavi cercate, K oppure un tipo equivalente.
+ * @param chiavi array di n chiavi.
+ * @param n numero di chiavi.
+ * @param risultati array di n elementi: risultati[i] riceve l'elemento della chiave
+ * chiavi[i], se presente, altrimenti non viene modificato.
+ * @param trovati array di (n + 63) / 64 parole: il bit i % 64 della parola i / 64
+ * vale 1 se e solo se chiavi[i] è presente.
+ * @return numero di chiavi presenti.
+ */
+template<class K, class E, class H, class A>
+template<class Q, class>
+int ClosedHash<K,E,H,A>::recuperaMolti(const Q* chiavi, int n, Element* risultati, uint64_t* trovati) const {
+    if (n < 0)
+        throw std::invalid_argument("Error: il numero di chiavi non puo' essere negativo.");
+    std::fill(trovati, trovati + (n + 63) / 64, 0);
+
+    int presenti = 0;
+    int home[BLOCCO_RICERCHE];
+    for (int inizio = 0; inizio < n; inizio += BLOCCO_RICERCHE) {
+        int fine = std::min(n, inizio + BLOCCO_RICERCHE);
+        for (int i = inizio; i < fine; i++) {
+            int j = calcHome(chiavi[i]);
+            home[i - inizio] = j;
+            precarica(&stato[j]);
+            precarica(&buckets[j]);
+        }
+        for (int i = inizio; i < fine; i++) {
+            int j = cercaSlot(chiavi[i], home[i - inizio], stato, buckets, bitIndice);
+            const Couple<K,E>* c = nullptr;
+            if (j != -1) {
+                c = &buckets[j];
+            } else if (vecchiBuckets != nullptr) {
+                j = cercaSlot(chiavi[i], vecchioStato, vecchiBuckets, vecchioBitIndice);
+                c = j != -1 ? &vecchiBuckets[j] : nullptr;
+            }
+            contaRicerca(c != nullptr);
+            if (c != nullptr) {
+                risultati[i] = c->getElement();
+                trovati[i / 64] |= uint64_t(1) << (i % 64);
+                presenti++;
+            }
+        }
     }
+    return presenti;
 }
 /**
  * @brief Metodo che resetta il dizionario.
  * @tparam K tipo della chiave.
  * @tparam E tipo dell'elemento.
  */
-template<class K, class E>
-void ClosedHash<K,E>::clear() {
-    for (int i = 0; i < maxBuckets; i++) {
-        delete buckets[i];
-        buckets[i] = nullptr;
+template<class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::clear() {
+    for (int i = 0; !DISTRUZIONE_BANALE && i < maxBuckets; i++) {
+        if (stato[i] >= OCCUPATO)
+            buckets[i].~Couple<K,E>();
     }
+    std::fill(stato, stato + maxBuckets, static_cast<unsigned char>(VUOTO));
     bucketsUsed = 0;
+    bucketsDeleted = 0;
+    liberaVecchi();
+}
+/**
+ * @brief Metodo che prepara il dizionario a contenere n coppie senza ridimensionamenti.
+ * Se necessario la tabella viene portata, con un'unica ricostruzione, alla minima
+ * potenza di 2 per cui n coppie non superano il fattore di carico massimo.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param n numero di coppie previste.
+ */
+template<class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::reserve(int n) {
+    if (n < 0)
+        throw std::invalid_argument("Error: il numero di coppie previste non puo' essere negativo.");
+    long long dim = maxBuckets;
+    while ((double)n > (double)dim * 0.75)
+        dim *= 2;
+    if (dim > (1 << 30))
+        throw std::length_error("Error: numero di coppie previste troppo elevato.");
+    if (dim > maxBuckets)
+        changeMaxBuckets(static_cast<int>(dim));
 }
 /**
  * @brief Metodo che restituisce una lista contenente tutte le chiavi del dizionario.
@@ -274,12 +895,16 @@ void ClosedHash<K,E>::clear() {
  * @tparam E tipo dell'elemento.
  * @return lista contenente tutte le chiavi del dizionario.
  */
-template <class K, class E>
-VectorList<K> ClosedHash<K,E>::keys() const {
+template <class K, class E, class H, class A>
+VectorList<K> ClosedHash<K,E,H,A>::keys() const {
     VectorList<K> keys;
     for (int i = 0; i < maxBuckets; i++) {
-        if (buckets[i] != nullptr)
-            keys.inserisciCoda(buckets[i]->getKey());
+        if (stato[i] >= OCCUPATO)
+            keys.inserisciCoda(buckets[i].getKey());
+    }
+    for (int i = 0; vecchiBuckets != nullptr && i < vecchiaDim; i++) {
+        if (vecchioStato[i] >= OCCUPATO)
+            keys.inserisciCoda(vecchiBuckets[i].getKey());
     }
     return keys;
 }
@@ -289,35 +914,41 @@ VectorList<K> ClosedHash<K,E>::keys() const {
  * @tparam E tipo dell'elemento.
  * @return lista contenente tutti gli elementi del dizionario.
  */
-template <class K, class E>
-VectorList<E> ClosedHash<K,E>::values() const {
+template <class K, class E, class H, class A>
+VectorList<E> ClosedHash<K,E,H,A>::values() const {
     VectorList<E> values;
     for (int i = 0; i < maxBuckets; i++) {
-        if (buckets[i] != nullptr)
-            values.inserisciCoda(buckets[i]->getElement());
+        if (stato[i] >= OCCUPATO)
+            values.inserisciCoda(buckets[i].getElement());
+    }
+    for (int i = 0; vecchiBuckets != nullptr && i < vecchiaDim; i++) {
+        if (vecchioStato[i] >= OCCUPATO)
+            values.inserisciCoda(vecchiBuckets[i].getElement());
     }
     return values;
 }
 /**
- * @brief Operatore di assegnamento.
+ * @brief Operatore di assegnamento. Il dizionario conserva il proprio allocatore.
+ * Le tabelle di mp vengono copiate prima di rilasciare quelle attuali: se la copia
+ * fallisce, il dizionario resta invariato.
  * @tparam K tipo della chiave.
  * @tparam E tipo dell'elemento.
  * @param mp dizionario da assegnare.
- * @return true se i dizionari sono uguali, false altrimenti.
+ * @return riferimento al dizionario.
  */
-template<class K, class E>
-ClosedHash<K,E> &ClosedHash<K,E>::operator=(const ClosedHash<K,E> &mp) {
+template<class K, class E, class H, class A>
+ClosedHash<K,E,H,A> &ClosedHash<K,E,H,A>::operator=(const ClosedHash<K,E,H,A> &mp) {
     if (this != &mp) {
-        clear();
-        maxBuckets = mp.maxBuckets;
-        bucketsUsed = mp.bucketsUsed;
-        buckets = new Couple<Key,Element>* [maxBuckets];
-        for (int i = 0; i < maxBuckets; i++) {
-            if (mp.buckets[i] != nullptr)
-                buckets[i] = new Couple<Key, Element>(mp.buckets[i]->getKey(), mp.buckets[i]->getElement());
-            else
-                buckets[i] = nullptr;
-        }
+        Couple<K,E>* coppie = buckets;
+        unsigned char* stati = stato;
+        int dim = maxBuckets;
+        Couple<K,E>* vecchieCoppie = vecchiBuckets;
+        unsigned char* vecchiStati = vecchioStato;
+        int dimVecchia = vecchiaDim;
+        copiaBuckets(mp);
+        distruggiTabella(coppie, stati, dim);
+        if (vecchieCoppie != nullptr)
+            distruggiTabella(vecchieCoppie, vecchiStati, dimVecchia);
     }
     return *this;
 }
@@ -328,13 +959,17 @@ ClosedHash<K,E> &ClosedHash<K,E>::operator=(const ClosedHash<K,E> &mp) {
  * @param mp dizionario da confrontare.
  * @return true se i dizionari sono uguali, false altrimenti.
  */
-template <class K, class E>
-bool ClosedHash<K,E>::operator==(const ClosedHash<K,E>& mp) const {
+template <class K, class E, class H, class A>
+bool ClosedHash<K,E,H,A>::operator==(const ClosedHash<K,E,H,A>& mp) const {
     if (this->lunghezza() != mp.lunghezza())
         return false;
     else {
         for (int i = 0; i < maxBuckets; i++) {
-            if (buckets[i] != nullptr && !mp.appartiene(buckets[i]->getKey()))
+            if (stato[i] >= OCCUPATO && !mp.appartiene(buckets[i].getKey()))
+                return false;
+        }
+        for (int i = 0; vecchiBuckets != nullptr && i < vecchiaDim; i++) {
+            if (vecchioStato[i] >= OCCUPATO && !mp.appartiene(vecchiBuckets[i].getKey()))
                 return false;
         }
         return true;
@@ -347,8 +982,8 @@ bool ClosedHash<K,E>::operator==(const ClosedHash<K,E>& mp) const {
  * @param mp dizionario da confrontare.
  * @return true se i dizionari sono diversi, false altrimenti.
  */
- template <class K, class E>
-bool ClosedHash<K,E>::operator!=(const ClosedHash<K,E>& mp) const {
+template <class K, class E, class H, class A>
+bool ClosedHash<K,E,H,A>::operator!=(const ClosedHash<K,E,H,A>& mp) const {
     return !(*this == mp);
 }
 /**
@@ -359,67 +994,858 @@ bool ClosedHash<K,E>::operator!=(const ClosedHash<K,E>& mp) const {
  * @param mp dizionario da stampare.
  * @return stream di output.
  */
-template <class K, class E>
-ostream& operator<<(ostream& os, const ClosedHash<K,E>& mp) {
+template <class K, class E, class H, class A>
+ostream& operator<<(ostream& os, const ClosedHash<K,E,H,A>& mp) {
+    VectorList<K> keys = mp.keys();
     os << "{";
-    for (int i = 0; i < mp.maxBuckets; i++) {
-        if (mp.buckets[i] != nullptr) {
-            os << mp.buckets[i]->getKey() << ": " << mp.buckets[i]->getElement();
-            if (i != mp.maxBuckets - 1)
-                os << ", ";
-        }
+    for (int p = 1; p <= keys.lunghezza(); p++) {
+        os << keys.leggiLista(p) << ": " << mp.find(keys.leggiLista(p))->getElement();
+        if (p != keys.lunghezza())
+            os << ", ";
     }
     os << "}";
     return os;
 }
+/**
+ * @brief Metodo che ottiene dall'allocatore la memoria di una tabella di dim bucket:
+ * le coppie, grezze, e i byte di controllo, non inizializzati.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param dim numero di bucket.
+ * @param coppie riceve l'array delle coppie.
+ * @param stati riceve l'array dei byte di controllo.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::allocaTabella(int dim, Couple<K,E>*& coppie, unsigned char*& stati) {
+    AllocatoreStato allocatoreStato(allocatore);
+    coppie = TrattiCoppie::allocate(allocatore, dim);
+    try {
+        stati = TrattiStato::allocate(allocatoreStato, dim);
+    } catch (...) {
+        TrattiCoppie::deallocate(allocatore, coppie, dim);
+        throw;
+    }
+}
+/**
+ * @brief Metodo che restituisce all'allocatore la memoria di una tabella di dim
+ * bucket, le cui coppie sono già state distrutte.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param coppie array delle coppie.
+ * @param stati array dei byte di controllo.
+ * @param dim numero di bucket.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::rilasciaTabella(Couple<K,E>* coppie, unsigned char* stati, int dim) {
+    AllocatoreStato allocatoreStato(allocatore);
+    TrattiCoppie::deallocate(allocatore, coppie, dim);
+    TrattiStato::deallocate(allocatoreStato, stati, dim);
+}
+/**
+ * @brief Metodo che distrugge le coppie presenti in una tabella di dim bucket e ne
+ * restituisce la memoria all'allocatore.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param coppie array delle coppie.
+ * @param stati array dei byte di controllo.
+ * @param dim numero di bucket.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::distruggiTabella(Couple<K,E>* coppie, unsigned char* stati, int dim) {
+    for (int i = 0; !DISTRUZIONE_BANALE && i < dim; i++) {
+        if (stati[i] >= OCCUPATO)
+            coppie[i].~Couple<K,E>();
+    }
+    rilasciaTabella(coppie, stati, dim);
+}
+/**
+ * @brief Metodo che alloca una copia di una tabella di dim bucket, con le coppie
+ * nelle stesse posizioni e gli stessi byte di controllo.
+ * Se la copia di una coppia solleva un'eccezione, le coppie già copiate vengono
+ * distrutte e la memoria rilasciata prima di propagarla.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param origine coppie da copiare.
+ * @param statoOrigine byte di controllo da copiare.
+ * @param dim numero di bucket.
+ * @param coppie riceve l'array delle coppie copiate.
+ * @param stati riceve l'array dei byte di controllo copiati.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::copiaTabella(const Couple<K,E>* origine, const unsigned char* statoOrigine, int dim,
+                                       Couple<K,E>*& coppie, unsigned char*& stati) {
+    allocaTabella(dim, coppie, stati);
+    int i = 0;
+    try {
+        for (; i < dim; i++) {
+            if (statoOrigine[i] >= OCCUPATO)
+                new (&coppie[i]) Couple<K,E>(origine[i]);
+        }
+    } catch (...) {
+        for (int j = 0; j < i; j++) {
+            if (statoOrigine[j] >= OCCUPATO)
+                coppie[j].~Couple<K,E>();
+        }
+        rilasciaTabella(coppie, stati, dim);
+        throw;
+    }
+    std::copy(statoOrigine, statoOrigine + dim, stati);
+}
+/**
+ * @brief Metodo che alloca newDim bucket vuoti.
+ * La memoria delle coppie viene allocata grezza: ogni coppia viene costruita
+ * direttamente nel proprio bucket al momento dell'inserimento.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param newDim numero di bucket da allocare, potenza di 2.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::allocaBuckets(int newDim) {
+    allocaTabella(newDim, buckets, stato);
+    std::fill(stato, stato + newDim, static_cast<unsigned char>(VUOTO));
+    maxBuckets = newDim;
+    bitIndice = 0;
+    while ((1 << bitIndice) < newDim)
+        bitIndice++;
+}
+/**
+ * @brief Metodo che distrugge le coppie presenti e rilascia i bucket.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::liberaBuckets() {
+    distruggiTabella(buckets, stato, maxBuckets);
+    liberaVecchi();
+}
+/**
+ * @brief Metodo che copia i bucket di h, nelle stesse posizioni e con lo stesso stato.
+ * I bucket cancellati vengono mantenuti, in modo da preservare le sequenze di sondaggio.
+ * I membri vengono sovrascritti solo dopo che tutte le copie sono riuscite: le
+ * tabelle precedenti, se esistono, restano al chiamante.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param h dizionario da copiare.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::copiaBuckets(const ClosedHash<K,E,H,A>& h) {
+    Couple<K,E>* coppie;
+    unsigned char* stati;
+    copiaTabella(h.buckets, h.stato, h.maxBuckets, coppie, stati);
+
+    // Anche la tabella in corso di trasferimento viene copiata così com'è
+    Couple<K,E>* vecchieCoppie = nullptr;
+    unsigned char* vecchiStati = nullptr;
+    if (h.vecchiBuckets != nullptr) {
+        try {
+            copiaTabella(h.vecchiBuckets, h.vecchioStato, h.vecchiaDim, vecchieCoppie, vecchiStati);
+        } catch (...) {
+            distruggiTabella(coppie, stati, h.maxBuckets);
+            throw;
+        }
+    }
+
+    politica = h.politica;
+    ridimensionamento = h.ridimensionamento;
+    buckets = coppie;
+    stato = stati;
+    maxBuckets = h.maxBuckets;
+    bitIndice = h.bitIndice;
+    bucketsUsed = h.bucketsUsed;
+    bucketsDeleted = h.bucketsDeleted;
+    vecchiBuckets = vecchieCoppie;
+    vecchioStato = vecchiStati;
+    bool inTrasferimento = vecchieCoppie != nullptr;
+    vecchiaDim = inTrasferimento ? h.vecchiaDim : 0;
+    vecchioBitIndice = inTrasferimento ? h.vecchioBitIndice : 0;
+    vecchiUsati = inTrasferimento ? h.vecchiUsati : 0;
+    cursore = inTrasferimento ? h.cursore : 0;
+}
+/**
+ * @brief Metodo che restituisce la lunghezza di sondaggio massima.
+ * La lunghezza di sondaggio di una coppia è la sua distanza dal bucket ideale
+ * (0 se si trova nel bucket ideale).
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return massima lunghezza di sondaggio tra le coppie presenti, 0 se il dizionario è vuoto.
+ */
+template <class K, class E, class H, class A>
+int ClosedHash<K,E,H,A>::sondaggioMassimo() const {
+    int massimo = 0;
+    for (int i = 0; i < maxBuckets; i++) {
+        if (stato[i] >= OCCUPATO && distanza(i) > massimo)
+            massimo = distanza(i);
+    }
+    return massimo;
+}
+/**
+ * @brief Metodo che restituisce la lunghezza di sondaggio media.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return media delle lunghezze di sondaggio delle coppie presenti, 0 se il dizionario è vuoto.
+ */
+template <class K, class E, class H, class A>
+double ClosedHash<K,E,H,A>::sondaggioMedio() const {
+    if (dizionarioVuoto())
+        return 0;
+    long totale = 0;
+    for (int i = 0; i < maxBuckets; i++) {
+        if (stato[i] >= OCCUPATO)
+            totale += distanza(i);
+    }
+    return (double)totale / bucketsUsed;
+}
+/**
+ * @brief Metodo che restituisce l'istogramma delle lunghezze di sondaggio.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista in cui la posizione d + 1 contiene il numero di coppie con
+ * lunghezza di sondaggio d, per d da 0 a sondaggioMassimo().
+ */
+template <class K, class E, class H, class A>
+VectorList<int> ClosedHash<K,E,H,A>::istogrammaSondaggi() const {
+    VectorList<int> istogramma;
+    if (dizionarioVuoto())
+        return istogramma;
+    int massimo = sondaggioMassimo();
+    for (int d = 0; d <= massimo; d++)
+        istogramma.inserisciCoda(0);
+    for (int i = 0; i < maxBuckets; i++) {
+        if (stato[i] >= OCCUPATO) {
+            int p = distanza(i) + 1;
+            istogramma.scriviLista(istogramma.leggiLista(p) + 1, p);
+        }
+    }
+    return istogramma;
+}
+/**
+ * @brief Metodo che ricostruisce la tabella sul posto eliminando i bucket cancellati.
+ * Non alloca nuova memoria: ogni coppia viene spostata nel primo bucket libero
+ * della propria sequenza di sondaggio, scambiandola con le coppie non ancora
+ * riposizionate quando necessario. Con Robin Hood non ha effetto.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::riorganizza() {
+    if (politica == Sondaggio::ROBIN_HOOD)
+        return; // Robin Hood non lascia bucket cancellati
+    Cronometro cronometro(this, true);
+
+    for (int i = 0; i < maxBuckets; i++)
+        stato[i] = (stato[i] >= OCCUPATO) ? DA_SPOSTARE : VUOTO;
+    bucketsDeleted = 0;
+
+    for (int i = 0; i < maxBuckets; i++) {
+        while (stato[i] == DA_SPOSTARE) {
+            int j = calcHome(buckets[i].getKey());
+            while (stato[j] == OCCUPATO)
+                j = (j + 1) & (maxBuckets - 1);
+
+            if (j == i) {
+                // La coppia è già nel primo bucket libero della sua sequenza
+                stato[i] = OCCUPATO;
+            } else if (stato[j] == VUOTO) {
+                new (&buckets[j]) Couple<K,E>(std::move(buckets[i]));
+                buckets[i].~Couple<K,E>();
+                stato[j] = OCCUPATO;
+                stato[i] = VUOTO;
+            } else {
+                // stato[j] == DA_SPOSTARE: scambia e riesamina la coppia arrivata in i
+                std::swap(buckets[j], buckets[i]);
+                stato[j] = OCCUPATO;
+            }
+        }
+    }
+}
+/**
+ * @brief Metodo che libera spazio per un nuovo inserimento.
+ * Se la maggior parte dei bucket non vuoti è costituita da bucket cancellati la
+ * tabella viene riorganizzata sul posto, altrimenti ne viene raddoppiata la dimensione.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::liberaSpazio() {
+    if ((double)bucketsUsed < (double)maxBuckets * 0.375) {
+        // In modalità incrementale anche la pulizia dei bucket cancellati avviene a passi
+        if (ridimensionamento == Ridimensionamento::INCREMENTALE && vecchiBuckets == nullptr)
+            avviaTrasferimento(maxBuckets);
+        else
+            riorganizza();
+    } else {
+        ingrandisci(maxBuckets * 2);
+    }
+}
+/**
+ * @brief Metodo che raddoppia la tabella secondo la modalità di ridimensionamento.
+ * Se un trasferimento incrementale è già in corso la crescita avviene subito, con
+ * changeMaxBuckets, che completa anche il trasferimento.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param newDim nuova dimensione della tabella.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::ingrandisci(int newDim) {
+    if (ridimensionamento == Ridimensionamento::INCREMENTALE && vecchiBuckets == nullptr)
+        avviaTrasferimento(newDim);
+    else
+        changeMaxBuckets(newDim);
+}
+/**
+ * @brief Metodo che avvia un trasferimento incrementale verso una tabella di newDim bucket.
+ * La tabella corrente diventa la vecchia tabella, da cui le coppie vengono trasferite
+ * da passoTrasferimento(); i nuovi inserimenti avvengono nella nuova tabella.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param newDim dimensione della nuova tabella, potenza di 2.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::avviaTrasferimento(int newDim) {
+    Cronometro cronometro(this, true);
+    vecchiBuckets = buckets;
+    vecchioStato = stato;
+    vecchiaDim = maxBuckets;
+    vecchioBitIndice = bitIndice;
+    vecchiUsati = bucketsUsed;
+    cursore = 0;
+    allocaBuckets(newDim);
+    bucketsUsed = 0;
+    bucketsDeleted = 0;
+}
+/**
+ * @brief Metodo che trasferisce nella tabella corrente al più PASSO_TRASFERIMENTO
+ * coppie della vecchia tabella, visitando al più 8 * PASSO_TRASFERIMENTO bucket.
+ * I bucket svuotati nella vecchia tabella vengono marcati come cancellati, così che
+ * le ricerche delle coppie non ancora trasferite proseguano correttamente.
+ * Al termine del trasferimento la vecchia tabella viene liberata.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::passoTrasferimento() {
+    if (vecchiBuckets == nullptr)
+        return;
+    Cronometro cronometro(this, false);
+    int spostate = 0;
+    for (int visitati = 0; vecchiBuckets != nullptr && spostate < PASSO_TRASFERIMENTO
+                           && visitati < 8 * PASSO_TRASFERIMENTO; visitati++) {
+        int i = cursore++;
+        if (vecchioStato[i] >= OCCUPATO) {
+            trasferisci(i);     // può completare il trasferimento (changeMaxBuckets)
+            spostate++;
+        }
+        if (vecchiBuckets != nullptr && cursore == vecchiaDim)
+            liberaVecchi();
+    }
+}
+/**
+ * @brief Metodo che sposta la coppia del bucket i della vecchia tabella nella tabella corrente.
+ * Se la tabella corrente ha raggiunto il fattore di carico massimo viene raddoppiata
+ * subito, assorbendo anche il resto della vecchia tabella.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param i indice di un bucket occupato della vecchia tabella.
+ * @return l'indice del bucket della tabella corrente in cui si trova la coppia.
+ */
+template <class K, class E, class H, class A>
+int ClosedHash<K,E,H,A>::trasferisci(int i) {
+    Couple<K,E> c(std::move(vecchiBuckets[i]));
+    vecchiBuckets[i].~Couple<K,E>();
+    vecchioStato[i] = CANCELLATO;
+    vecchiUsati--;
+    if ((double)(bucketsUsed + bucketsDeleted) >= (double)maxBuckets * 0.75)
+        changeMaxBuckets(maxBuckets * 2);
+    return posiziona(std::move(c));
+}
+/**
+ * @brief Metodo che distrugge le coppie rimaste nella vecchia tabella e la rilascia.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::liberaVecchi() {
+    if (vecchiBuckets == nullptr)
+        return;
+    distruggiTabella(vecchiBuckets, vecchioStato, vecchiaDim);
+    vecchiBuckets = nullptr;
+    vecchiUsati = 0;
+}
+/**
+ * @brief Metodo che inserisce una coppia costruita con gli argomenti args, se la
+ * chiave key non è già presente.
+ * Con sondaggio lineare la coppia viene costruita direttamente nel bucket trovato;
+ * con Robin Hood viene costruita una sola volta e poi spostata lungo la sequenza.
+ * La coppia viene costruita solo dopo l'ultimo utilizzo di key, che può quindi
+ * riferirsi a un oggetto spostato nella coppia stessa.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia da inserire.
+ * @param args argomenti del costruttore di Couple<K, E>.
+ * @return indice del bucket contenente la chiave key e true se la coppia è stata
+ * inserita, false se la chiave era già presente.
+ */
+template <class K, class E, class H, class A>
+template <class... Args>
+std::pair<int, bool> ClosedHash<K,E,H,A>::inserisciSeAssente(const Key& key, Args&&... args) {
+    if (vecchiBuckets != nullptr) {
+        // La chiave può trovarsi ancora nella vecchia tabella: in tal caso viene
+        // trasferita subito, così che l'indice restituito si riferisca a buckets
+        int i = cercaSlot(key);
+        if (i != -1)
+            return {i, false};
+        int j = cercaSlot(key, vecchioStato, vecchiBuckets, vecchioBitIndice);
+        if (j != -1)
+            return {trasferisci(j), false};
+        passoTrasferimento();
+    }
+
+    if (politica == Sondaggio::ROBIN_HOOD) {
+        int i = cercaSlot(key);
+        if (i != -1)
+            return {i, false};
+        if ((double)bucketsUsed >= (double)maxBuckets * 0.75)
+            ingrandisci(maxBuckets * 2);
+        return {posiziona(Couple<K,E>(std::forward<Args>(args)...)), true};
+    }
+
+    // Individua l'indice del bucket in cui inserire la coppia
+    int i = calcPosition(key);
+    if (i != -1 && stato[i] >= OCCUPATO)
+        return {i, false};
+
+    // Se la coppia non riutilizza un bucket cancellato e il numero di bucket occupati
+    // o cancellati è maggiore o uguale al 75% del numero di bucket
+    if (i == -1 || (stato[i] == VUOTO && (double)(bucketsUsed + bucketsDeleted) >= (double)maxBuckets * 0.75)) {
+        liberaSpazio();
+        i = calcPosition(key);
+    }
+
+    if (stato[i] == CANCELLATO)
+        bucketsDeleted--;
+    new (&buckets[i]) Couple<K,E>(std::forward<Args>(args)...);
+    stato[i] = OCCUPATO;
+    bucketsUsed++;
+    return {i, true};
+}
 /**
  * @brief Metodo che modifica la dimensione del dizionario.
+ * Le coppie vengono spostate, senza copiarle, nella nuova tabella; i bucket
+ * cancellati non vengono riportati.
  * @tparam K tipo della chiave.
  * @tparam E tipo dell'elemento.
  * @param newDim nuova dimensione del dizionario.
  */
-template <class K, class E>
-void ClosedHash<K,E>::changeMaxBuckets(int newDim) {
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::changeMaxBuckets(int newDim) {
     if (newDim <= maxBuckets)
         throw std::invalid_argument("Error: La nuova dimensione deve essere maggiore di quella attuale.");
+    Cronometro cronometro(this, true);
 
-    Couple<K, E>** newBuckets = new Couple<K, E>*[newDim];
-    for (int i = 0; i < newDim; i++)
-        newBuckets[i] = nullptr;
+    // Un eventuale trasferimento incrementale in corso viene completato qui
+    Couple<K,E>* tabelle[2] = {buckets, vecchiBuckets};
+    unsigned char* stati[2] = {stato, vecchioStato};
+    int dimensioni[2] = {maxBuckets, vecchiaDim};
+    vecchiBuckets = nullptr;
+    vecchiUsati = 0;
 
-    for (int i = 0; i < maxBuckets; i++) {
-        if (buckets[i] != nullptr) {
-            int j = calcPosition(buckets[i]->getKey());
-            int k = j;
-            while (newBuckets[k] != nullptr)
-                k = (k + 1) % newDim;
-
-            newBuckets[k] = new Couple<K, E>(*buckets[i]);
-            delete buckets[i];
+    allocaBuckets(newDim);
+    bucketsUsed = 0;
+    bucketsDeleted = 0;
+    for (int t = 0; t < 2 && tabelle[t] != nullptr; t++) {
+        for (int i = 0; i < dimensioni[t]; i++) {
+            if (stati[t][i] >= OCCUPATO) {
+                Couple<K,E> c(std::move(tabelle[t][i]));
+                tabelle[t][i].~Couple<K,E>();
+                stati[t][i] = VUOTO;
+                posiziona(std::move(c));
+            }
         }
+        rilasciaTabella(tabelle[t], stati[t], dimensioni[t]);
+    }
+}
+/**
+ * @brief Metodo che posiziona una coppia la cui chiave non è presente, in una
+ * tabella priva di bucket cancellati. Non controlla il fattore di carico.
+ * Con Robin Hood, se la sequenza di sondaggio supera la distanza massima la
+ * tabella viene raddoppiata; se però la tabella è già molto più grande del numero
+ * di coppie la funzione hash è inadeguata e si passa al sondaggio lineare, che non
+ * ha limiti di distanza.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia da posizionare.
+ * @return indice del bucket in cui è stata posizionata la coppia.
+ */
+template <class K, class E, class H, class A>
+int ClosedHash<K,E,H,A>::posiziona(Couple<K,E>&& c) {
+    if (politica == Sondaggio::ROBIN_HOOD) {
+        preparaRobinHood(c.getKey());
+        if (politica == Sondaggio::ROBIN_HOOD)
+            return posizionaRobinHood(std::move(c));
+    }
+    int k = calcHome(c.getKey());
+    while (stato[k] != VUOTO)
+        k = (k + 1) & (maxBuckets - 1);
+    new (&buckets[k]) Couple<K,E>(std::move(c));
+    stato[k] = OCCUPATO;
+    bucketsUsed++;
+    return k;
+}
+/**
+ * @brief Metodo che ingrandisce la tabella finché una coppia con chiave key può
+ * essere posizionata con Robin Hood senza superare la distanza massima.
+ * Se la funzione hash è inadeguata passa invece al sondaggio lineare.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da posizionare, non presente nel dizionario.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::preparaRobinHood(const Key& key) {
+    while (politica == Sondaggio::ROBIN_HOOD && !verificaRobinHood(calcHome(key))) {
+        if ((double)bucketsUsed * 16 < (double)maxBuckets)
+            passaALineare();
+        else
+            changeMaxBuckets(maxBuckets * 2);
+    }
+}
+/**
+ * @brief Metodo che simula il posizionamento Robin Hood di una coppia con bucket
+ * ideale j, leggendo solo i byte di controllo.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param j bucket ideale della coppia.
+ * @return true se nessuna coppia spostata supera DISTANZA_MAX, false altrimenti.
+ */
+template <class K, class E, class H, class A>
+bool ClosedHash<K,E,H,A>::verificaRobinHood(int j) const {
+    for (int d = 0; d <= DISTANZA_MAX; d++) {
+        if (stato[j] == VUOTO)
+            return true;
+        int dj = stato[j] - OCCUPATO;
+        if (dj < d)
+            d = dj;
+        j = (j + 1) & (maxBuckets - 1);
+    }
+    return false;
+}
+/**
+ * @brief Metodo che posiziona una coppia secondo la politica Robin Hood.
+ * Percorrendo la sequenza di sondaggio, la coppia trasportata prende il posto di
+ * ogni coppia più vicina di lei al proprio bucket ideale, che diventa la nuova
+ * coppia trasportata. Le coppie vengono scambiate per spostamento.
+ * Non controlla duplicati, fattore di carico né distanza massima (vedi verificaRobinHood).
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia da posizionare.
+ * @return indice del bucket in cui è stata posizionata la coppia c.
+ */
+template <class K, class E, class H, class A>
+int ClosedHash<K,E,H,A>::posizionaRobinHood(Couple<K,E>&& c) {
+    int j = calcHome(c.getKey());
+    int posizione = -1;
+    for (int d = 0; ; d++) {
+        if (stato[j] == VUOTO) {
+            new (&buckets[j]) Couple<K,E>(std::move(c));
+            stato[j] = static_cast<unsigned char>(OCCUPATO + d);
+            bucketsUsed++;
+            return posizione == -1 ? j : posizione;
+        }
+        int dj = stato[j] - OCCUPATO;
+        if (dj < d) {
+            std::swap(buckets[j], c);
+            stato[j] = static_cast<unsigned char>(OCCUPATO + d);
+            d = dj;
+            if (posizione == -1)
+                posizione = j;
+        }
+        j = (j + 1) & (maxBuckets - 1);
     }
-
-    delete[] buckets;
-    buckets = newBuckets;
-    maxBuckets = newDim;
+}
+/**
+ * @brief Metodo che passa dal sondaggio Robin Hood al sondaggio lineare.
+ * La disposizione delle coppie resta valida: basta dimenticare le distanze.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::passaALineare() {
+    politica = Sondaggio::LINEARE;
+    for (int i = 0; i < maxBuckets; i++) {
+        if (stato[i] >= OCCUPATO)
+            stato[i] = OCCUPATO;
+    }
+}
+/**
+ * @brief Metodo che calcola il bucket ideale di una chiave.
+ * L'hash viene moltiplicato per 2^64 / phi e si prendono i bitIndice bit più alti
+ * del risultato: ogni bit dell'hash influenza l'indice, che resta ben distribuito
+ * anche con funzioni hash i cui bit bassi sono poco variabili.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @return indice del bucket ideale.
+ */
+template <class K, class E, class H, class A>
+template <class Q>
+int ClosedHash<K,E,H,A>::calcHome(const Q& key) const {
+    return calcHome(key, bitIndice);
+}
+/**
+ * @brief Metodo che calcola il bucket ideale di una chiave in una tabella di 2^bit bucket.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param bit logaritmo in base 2 della dimensione della tabella.
+ * @return indice del bucket ideale.
+ */
+template <class K, class E, class H, class A>
+template <class Q>
+int ClosedHash<K,E,H,A>::calcHome(const Q& key, int bit) const {
+    return static_cast<int>((uint64_t(hash(key)) * 0x9E3779B97F4A7C15ULL) >> (64 - bit));
 }
 /**
  * @brief Metodo che calcola la posizione di una chiave all'interno del dizionario.
+ * La sequenza di sondaggio termina al primo bucket vuoto: se la chiave è presente
+ * viene restituito il suo bucket, altrimenti il primo bucket cancellato incontrato
+ * oppure, in sua assenza, il bucket vuoto in cui inserirla.
  * @tparam K tipo della chiave.
  * @tparam E tipo dell'elemento.
  * @param key chiave da cercare.
- * @return posizione della chiave all'interno del dizionario.
+ * @return posizione della chiave all'interno del dizionario, -1 se non esiste un bucket libero.
  */
-template <class K, class E>
-int ClosedHash<K,E>::calcPosition(const Key& key) const {
-    int i = static_cast<int>(hash(key) % maxBuckets);
-    for (int j = i;; j = (j + 1) % maxBuckets) {
-        if (buckets[j] == nullptr || buckets[j]->getKey() == key)
+template <class K, class E, class H, class A>
+int ClosedHash<K,E,H,A>::calcPosition(const Key& key) const {
+    int j = calcHome(key);
+    int libero = -1;
+    for (int n = 0; n < maxBuckets; n++) {
+        if (stato[j] == VUOTO)
+            return libero != -1 ? libero : j;
+        if (stato[j] == CANCELLATO) {
+            if (libero == -1)
+                libero = j;
+        } else if (buckets[j].getKey() == key) {
             return j;
-        if (j == i)
-            break;
+        }
+        j = (j + 1) & (maxBuckets - 1);
     }
-    return -1; // Posizione non trovata
+    return libero; // Posizione non trovata se non ci sono bucket cancellati
+}
+/**
+ * @brief Metodo che individua il bucket contenente la chiave key con un solo sondaggio.
+ * La ricerca salta i bucket cancellati e si interrompe al primo bucket vuoto;
+ * con Robin Hood si interrompe anche alla prima coppia più vicina al proprio
+ * bucket ideale di quanto lo sarebbe la chiave cercata.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return indice del bucket contenente key, -1 se la chiave non è presente.
+ */
+template <class K, class E, class H, class A>
+template <class Q>
+int ClosedHash<K,E,H,A>::cercaSlot(const Q& key) const {
+    return cercaSlot(key, stato, buckets, bitIndice);
+}
+/**
+ * @brief Metodo che individua il bucket contenente la chiave key in una tabella qualsiasi,
+ * la corrente oppure quella in corso di trasferimento.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param st byte di controllo della tabella.
+ * @param b bucket della tabella.
+ * @param bit logaritmo in base 2 della dimensione della tabella.
+ * @return indice del bucket contenente key, -1 se la chiave non è presente.
+ */
+template <class K, class E, class H, class A>
+template <class Q>
+int ClosedHash<K,E,H,A>::cercaSlot(const Q& key, const unsigned char* st, const Couple<K,E>* b, int bit) const {
+    return cercaSlot(key, calcHome(key, bit), st, b, bit);
+}
+/**
+ * @brief Versione di cercaSlot che parte da un bucket ideale già calcolato.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param j bucket ideale di key nella tabella.
+ * @param st byte di controllo della tabella.
+ * @param b bucket della tabella.
+ * @param bit logaritmo in base 2 della dimensione della tabella.
+ * @return indice del bucket contenente key, -1 se la chiave non è presente.
+ */
+template <class K, class E, class H, class A>
+template <class Q>
+int ClosedHash<K,E,H,A>::cercaSlot(const Q& key, int j, const unsigned char* st, const Couple<K,E>* b, int bit) const {
+    int dim = 1 << bit;
+    for (int d = 0; d < dim; d++) {
+        if (st[j] == VUOTO)
+            return -1;
+        if (st[j] >= OCCUPATO) {
+            // Con Robin Hood la chiave avrebbe preso il posto di una coppia più vicina
+            if (politica == Sondaggio::ROBIN_HOOD && st[j] - OCCUPATO < d)
+                return -1;
+            if (b[j].getKey() == key)
+                return j;
+        }
+        j = (j + 1) & (dim - 1);
+    }
+    return -1;
+}
+/**
+ * @brief Metodo che cerca la coppia con chiave key nella tabella corrente e,
+ * se è in corso un trasferimento, nella vecchia tabella.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia, nullptr se la chiave non è presente.
+ */
+template <class K, class E, class H, class A>
+template <class Q>
+Couple<K,E>* ClosedHash<K,E,H,A>::cercaCoppia(const Q& key) const {
+    Couple<K,E>* c = nullptr;
+    int i = cercaSlot(key);
+    if (i != -1) {
+        c = &buckets[i];
+    } else if (vecchiBuckets != nullptr) {
+        i = cercaSlot(key, vecchioStato, vecchiBuckets, vecchioBitIndice);
+        if (i != -1)
+            c = &vecchiBuckets[i];
+    }
+    contaRicerca(c != nullptr);
+    return c;
+}
+/**
+ * @brief Metodo che calcola la distanza della coppia nel bucket i dal proprio bucket ideale.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param i indice di un bucket occupato.
+ * @return numero di bucket da scorrere, a partire da quello ideale, per raggiungere i.
+ */
+template <class K, class E, class H, class A>
+int ClosedHash<K,E,H,A>::distanza(int i) const {
+    int ideale = calcHome(buckets[i].getKey());
+    return (i - ideale) & (maxBuckets - 1);
+}
+/**
+ * @brief Metodo che individua il primo bucket occupato a partire dalla posizione i,
+ * proseguendo nella vecchia tabella dopo l'ultimo bucket della tabella corrente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param i posizione da cui iniziare la ricerca.
+ * @return posizione del primo bucket occupato, fine() se non ce ne sono altri.
+ */
+template <class K, class E, class H, class A>
+int ClosedHash<K,E,H,A>::prossimo(int i) const {
+    for (; i < maxBuckets; i++) {
+        if (stato[i] >= OCCUPATO)
+            return i;
+    }
+    for (; vecchiBuckets != nullptr && i < maxBuckets + vecchiaDim; i++) {
+        if (vecchioStato[i - maxBuckets] >= OCCUPATO)
+            return i;
+    }
+    return fine();
+}
+/**
+ * @brief Metodo che chiede al processore di portare in cache la linea che contiene p,
+ * senza attenderne l'arrivo. Senza un'istruzione di prefetch disponibile non fa nulla.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param p indirizzo da precaricare.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::precarica(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+/**
+ * @brief Metodo che raccoglie le statistiche del dizionario.
+ * Capacità, carico e sondaggi si riferiscono alla tabella corrente; i contatori sono
+ * disponibili solo se il dizionario è compilato con CLOSEDHASH_STATISTICHE.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return statistiche del dizionario.
+ */
+template <class K, class E, class H, class A>
+StatisticheHash ClosedHash<K,E,H,A>::statistiche() const {
+    StatisticheHash s;
+    s.capacita = maxBuckets;
+    s.coppie = lunghezza();
+    s.cancellati = bucketsDeleted;
+    s.fattoreCarico = (double)(bucketsUsed + bucketsDeleted) / maxBuckets;
+    long totale = 0;
+    for (int i = 0; i < maxBuckets; i++) {
+        if (stato[i] >= OCCUPATO) {
+            int d = distanza(i);
+            if (d >= (int)s.istogramma.size())
+                s.istogramma.resize(d + 1, 0);
+            s.istogramma[d]++;
+            totale += d;
+        }
+    }
+    s.sondaggioMassimo = s.istogramma.empty() ? 0 : (int)s.istogramma.size() - 1;
+    s.sondaggioMedio = bucketsUsed == 0 ? 0 : (double)totale / bucketsUsed;
+    s.trasferimentoInCorso = vecchiBuckets != nullptr;
+#if defined(CLOSEDHASH_STATISTICHE)
+    s.contatori = true;
+    s.ridimensionamenti = contatori.ridimensionamenti;
+    s.secondiRidimensionamenti = std::chrono::duration<double>(contatori.tempo).count();
+    s.ricercheRiuscite = contatori.riuscite.load(std::memory_order_relaxed);
+    s.ricercheFallite = contatori.fallite.load(std::memory_order_relaxed);
+#endif
+    return s;
+}
+/**
+ * @brief Metodo che conta una ricerca riuscita o fallita (solo con CLOSEDHASH_STATISTICHE).
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param trovata true se la chiave cercata è presente.
+ */
+template <class K, class E, class H, class A>
+void ClosedHash<K,E,H,A>::contaRicerca(bool trovata) const {
+#if defined(CLOSEDHASH_STATISTICHE)
+    (trovata ? contatori.riuscite : contatori.fallite).fetch_add(1, std::memory_order_relaxed);
+#else
+    (void)trovata;
+#endif
+}
+/**
+ * @brief Costruttore che avvia la misura.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param d dizionario di cui misurare il ridimensionamento.
+ * @param conta true se l'operazione va contata tra i ridimensionamenti.
+ */
+template <class K, class E, class H, class A>
+ClosedHash<K,E,H,A>::Cronometro::Cronometro(const ClosedHash* d, bool conta) {
+#if defined(CLOSEDHASH_STATISTICHE)
+    this->d = d;
+    esterno = d->contatori.annidamento++ == 0;
+    if (conta)
+        d->contatori.ridimensionamenti++;
+    if (esterno)
+        inizio = std::chrono::steady_clock::now();
+#else
+    (void)d;
+    (void)conta;
+#endif
+}
+/**
+ * @brief Distruttore che aggiunge la durata misurata al tempo dei ridimensionamenti.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class H, class A>
+ClosedHash<K,E,H,A>::Cronometro::~Cronometro() {
+#if defined(CLOSEDHASH_STATISTICHE)
+    d->contatori.annidamento--;
+    if (esterno)
+        d->contatori.tempo += std::chrono::steady_clock::now() - inizio;
+#endif
 }
 
 #endif //DICTIONARY_CLOSEDHASH_H
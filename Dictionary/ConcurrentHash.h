@@ -0,0 +1,343 @@
+#ifndef DICTIONARY_CONCURRENTHASH_H
+#define DICTIONARY_CONCURRENTHASH_H
+
+#include "Dictionary.h"
+#include "ClosedHash.h"
+#include "Hash.h"
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+/**
+ * @brief Classe che rappresenta un dizionario utilizzabile da più thread contemporaneamente.
+ * Le coppie sono suddivise tra un numero fisso (potenza di 2) di partizioni indipendenti,
+ * ognuna delle quali è un ClosedHash protetto da un proprio lock lettori-scrittori:
+ * le letture sulla stessa partizione procedono in parallelo e le scritture bloccano
+ * soltanto la propria partizione.
+ * <br>
+ * La partizione di una chiave è data dai bit alti dell'hash rimescolato, così che la
+ * scelta della partizione sia indipendente dal bucket scelto all'interno di essa.
+ * Il numero di coppie è mantenuto in un contatore atomico e lunghezza() non acquisisce lock.
+ * <br>
+ * Ogni metodo è atomico rispetto alla propria chiave. keys(), values() e clear()
+ * visitano le partizioni una alla volta: in presenza di scritture concorrenti il
+ * risultato non corrisponde necessariamente a un unico istante.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam H funzione hash, per default Hash<K>.
+ */
+template <class K, class E, class H = Hash<K>>
+class ConcurrentHash : public Dictionary<K,E> {
+public:
+    typedef typename Dictionary<K,E>::Key Key;
+    typedef typename Dictionary<K,E>::Element Element;
+
+    ConcurrentHash();
+    ConcurrentHash(int);
+    ConcurrentHash(const ConcurrentHash&) = delete;
+    ConcurrentHash& operator=(const ConcurrentHash&) = delete;
+    ~ConcurrentHash();
+
+    bool dizionarioVuoto() const;
+    void inserisci(const Couple<Key,Element>&);
+    void inserisci(Couple<Key,Element>&&);
+    void cancella(const Key&);
+    Element recupera(const Key&) const;
+    bool appartiene(const Key&) const;
+    void aggiorna(const Key&, const Element&);
+
+    bool tryGet(const Key&, Element&) const;
+    template<class... Args>
+    bool try_emplace(const Key&, Args&&...);
+    template<class E1>
+    bool insert_or_assign(const Key&, E1&&);
+
+    void clear();
+    int lunghezza() const {return numElementi.load(std::memory_order_relaxed);}
+    int numeroPartizioni() const {return numPartizioni;}
+    VectorList<K> keys() const;
+    VectorList<E> values() const;
+
+private:
+    // Partizione allineata alla linea di cache, per evitare che i lock di
+    // partizioni diverse si contendano la stessa linea
+    struct alignas(64) Partizione {
+        mutable std::shared_mutex lock;
+        ClosedHash<K,E,H> tabella;
+    };
+
+    void allocaPartizioni(int);
+    Partizione& partizione(const Key&) const;
+    Partizione* partizioni;         // partizioni, in numero pari a una potenza di 2
+    int numPartizioni;
+    int bitPartizione;              // log2(numPartizioni)
+    std::atomic<int> numElementi;   // numero di coppie in tutte le partizioni
+    H hash;
+};
+/**
+ * @brief Costruttore di default: utilizza quattro partizioni per ogni thread
+ * hardware disponibile (almeno 16).
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+ConcurrentHash<K,E,H>::ConcurrentHash() : numElementi(0) {
+    int n = 4 * static_cast<int>(std::thread::hardware_concurrency());
+    allocaPartizioni(n < 16 ? 16 : n);
+}
+/**
+ * @brief Costruttore che inizializza un dizionario con almeno n partizioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param n numero minimo di partizioni, arrotondato alla potenza di 2 successiva.
+ */
+template<class K, class E, class H>
+ConcurrentHash<K,E,H>::ConcurrentHash(int n) : numElementi(0) {
+    if (n <= 0)
+        throw std::invalid_argument("Error: il numero di partizioni deve essere positivo.");
+    allocaPartizioni(n);
+}
+/**
+ * @brief Distruttore.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+ConcurrentHash<K,E,H>::~ConcurrentHash() {
+    delete[] partizioni;
+}
+/**
+ * @brief Metodo che controlla se il dizionario è vuoto.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return true se il dizionario è vuoto, false altrimenti.
+ */
+template<class K, class E, class H>
+bool ConcurrentHash<K,E,H>::dizionarioVuoto() const {
+    return lunghezza() == 0;
+}
+/**
+ * @brief Metodo che inserisce una coppia < K, E > nel dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param couple coppia da copiare nel dizionario.
+ */
+template<class K, class E, class H>
+void ConcurrentHash<K,E,H>::inserisci(const Couple<Key,Element>& couple) {
+    Partizione& p = partizione(couple.getKey());
+    std::unique_lock<std::shared_mutex> guardia(p.lock);
+    p.tabella.inserisci(couple);
+    numElementi.fetch_add(1, std::memory_order_relaxed);
+}
+/**
+ * @brief Metodo che inserisce una coppia < K, E > nel dizionario spostandola.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param couple coppia da spostare nel dizionario.
+ */
+template<class K, class E, class H>
+void ConcurrentHash<K,E,H>::inserisci(Couple<Key,Element>&& couple) {
+    Partizione& p = partizione(couple.getKey());
+    std::unique_lock<std::shared_mutex> guardia(p.lock);
+    p.tabella.inserisci(std::move(couple));
+    numElementi.fetch_add(1, std::memory_order_relaxed);
+}
+/**
+ * @brief Metodo che rimuove la coppia con chiave key dal dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ */
+template<class K, class E, class H>
+void ConcurrentHash<K,E,H>::cancella(const Key& key) {
+    Partizione& p = partizione(key);
+    std::unique_lock<std::shared_mutex> guardia(p.lock);
+    try {
+        p.tabella.cancella(key);
+    } catch (const std::out_of_range&) {
+        // Anche una partizione vuota segnala una chiave assente dall'intero dizionario
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    }
+    numElementi.fetch_sub(1, std::memory_order_relaxed);
+}
+/**
+ * @brief Metodo che restituisce una copia dell'elemento associato alla chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @return elemento associato alla chiave key.
+ */
+template<class K, class E, class H>
+typename ConcurrentHash<K,E,H>::Element ConcurrentHash<K,E,H>::recupera(const Key& key) const {
+    Partizione& p = partizione(key);
+    std::shared_lock<std::shared_mutex> guardia(p.lock);
+    const Couple<K,E>* c = p.tabella.find(key);
+    if (c == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    return c->getElement();
+}
+/**
+ * @brief Metodo che verifica se il dizionario contiene una coppia con chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @return true se il dizionario contiene una coppia con chiave key, false altrimenti.
+ */
+template<class K, class E, class H>
+bool ConcurrentHash<K,E,H>::appartiene(const Key& key) const {
+    Partizione& p = partizione(key);
+    std::shared_lock<std::shared_mutex> guardia(p.lock);
+    return p.tabella.appartiene(key);
+}
+/**
+ * @brief Metodo che aggiorna il valore associato a una chiave esistente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param element nuovo elemento.
+ */
+template<class K, class E, class H>
+void ConcurrentHash<K,E,H>::aggiorna(const Key& key, const Element& element) {
+    Partizione& p = partizione(key);
+    std::unique_lock<std::shared_mutex> guardia(p.lock);
+    Couple<K,E>* c = p.tabella.find(key);
+    if (c == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    c->setElement(element);
+}
+/**
+ * @brief Metodo che copia l'elemento associato a key senza sollevare eccezioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param element parametro di uscita in cui copiare l'elemento trovato.
+ * @return true se la chiave è presente, false altrimenti (element non viene modificato).
+ */
+template<class K, class E, class H>
+bool ConcurrentHash<K,E,H>::tryGet(const Key& key, Element& element) const {
+    Partizione& p = partizione(key);
+    std::shared_lock<std::shared_mutex> guardia(p.lock);
+    return p.tabella.tryGet(key, element);
+}
+/**
+ * @brief Metodo che inserisce una coppia con chiave key ed elemento costruito con
+ * gli argomenti args, solo se la chiave non è già presente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param args argomenti del costruttore dell'elemento.
+ * @return true se la coppia è stata inserita, false se la chiave era già presente.
+ */
+template<class K, class E, class H>
+template<class... Args>
+bool ConcurrentHash<K,E,H>::try_emplace(const Key& key, Args&&... args) {
+    Partizione& p = partizione(key);
+    std::unique_lock<std::shared_mutex> guardia(p.lock);
+    bool inserita = p.tabella.try_emplace(key, std::forward<Args>(args)...).second;
+    if (inserita)
+        numElementi.fetch_add(1, std::memory_order_relaxed);
+    return inserita;
+}
+/**
+ * @brief Metodo che inserisce la coppia < key, element > oppure, se la chiave è già
+ * presente, le assegna element.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param element elemento da inserire o assegnare.
+ * @return true se la coppia è stata inserita, false se è stata aggiornata.
+ */
+template<class K, class E, class H>
+template<class E1>
+bool ConcurrentHash<K,E,H>::insert_or_assign(const Key& key, E1&& element) {
+    Partizione& p = partizione(key);
+    std::unique_lock<std::shared_mutex> guardia(p.lock);
+    bool inserita = p.tabella.insert_or_assign(key, std::forward<E1>(element)).second;
+    if (inserita)
+        numElementi.fetch_add(1, std::memory_order_relaxed);
+    return inserita;
+}
+/**
+ * @brief Metodo che svuota il dizionario, una partizione alla volta.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+void ConcurrentHash<K,E,H>::clear() {
+    for (int i = 0; i < numPartizioni; i++) {
+        std::unique_lock<std::shared_mutex> guardia(partizioni[i].lock);
+        numElementi.fetch_sub(partizioni[i].tabella.lunghezza(), std::memory_order_relaxed);
+        partizioni[i].tabella.clear();
+    }
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutte le chiavi del dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutte le chiavi del dizionario.
+ */
+template<class K, class E, class H>
+VectorList<K> ConcurrentHash<K,E,H>::keys() const {
+    VectorList<K> keys;
+    for (int i = 0; i < numPartizioni; i++) {
+        std::shared_lock<std::shared_mutex> guardia(partizioni[i].lock);
+        VectorList<K> parziale = partizioni[i].tabella.keys();
+        for (int j = 1; j <= parziale.lunghezza(); j++)
+            keys.inserisciCoda(parziale.leggiLista(j));
+    }
+    return keys;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutti gli elementi del dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutti gli elementi del dizionario.
+ */
+template<class K, class E, class H>
+VectorList<E> ConcurrentHash<K,E,H>::values() const {
+    VectorList<E> values;
+    for (int i = 0; i < numPartizioni; i++) {
+        std::shared_lock<std::shared_mutex> guardia(partizioni[i].lock);
+        VectorList<E> parziale = partizioni[i].tabella.values();
+        for (int j = 1; j <= parziale.lunghezza(); j++)
+            values.inserisciCoda(parziale.leggiLista(j));
+    }
+    return values;
+}
+/**
+ * @brief Metodo che alloca almeno n partizioni vuote.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param n numero minimo di partizioni.
+ */
+template<class K, class E, class H>
+void ConcurrentHash<K,E,H>::allocaPartizioni(int n) {
+    numPartizioni = 1;
+    bitPartizione = 0;
+    while (numPartizioni < n) {
+        numPartizioni *= 2;
+        bitPartizione++;
+    }
+    partizioni = new Partizione[numPartizioni];
+}
+/**
+ * @brief Metodo che restituisce la partizione di una chiave.
+ * Si utilizzano i bit alti dell'hash rimescolato: ClosedHash ricava il bucket da una
+ * diversa combinazione dei bit, quindi le chiavi di una partizione restano ben
+ * distribuite tra i suoi bucket.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @return partizione che contiene, o conterrebbe, la chiave.
+ */
+template<class K, class E, class H>
+typename ConcurrentHash<K,E,H>::Partizione& ConcurrentHash<K,E,H>::partizione(const Key& key) const {
+    if (bitPartizione == 0)
+        return partizioni[0];
+    return partizioni[HashBase::mescola(uint64_t(hash(key))) >> (64 - bitPartizione)];
+}
+
+#endif //DICTIONARY_CONCURRENTHASH_H
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <ostream>
+#include <utility>
 
 /**
  * @brief Classe che rappresenta una coppia < K, E >.
@@ -16,15 +17,22 @@ public:
     typedef E Element;
     Couple() {}
     Couple(const Couple<K,E>& couple);
+    Couple(Couple<K,E>&& couple);
     Couple(const K& k, const E& e);
-    const K getKey() const;
-    const E getElement() const;
+    Couple(K&& k, E&& e);
+    template<class K1, class... Args>
+    Couple(std::piecewise_construct_t, K1&& k, Args&&... args);
+    const K& getKey() const;
+    const E& getElement() const;
+    E& getElement();
     void setKey(const K& k);
     void setElement(const E& e);
+    void setElement(E&& e);
 
     // operatori
     bool operator==(const Couple<K,E>& couple) const;
     Couple<K,E>& operator=(const Couple<K,E>& couple);
+    Couple<K,E>& operator=(Couple<K,E>&& couple);
     bool operator!=(const Couple<K,E>& couple) const;
 
     template<class K1, class E1>
@@ -40,10 +48,15 @@ private:
  * @param couple coppia da copiare.
  */
 template<class K, class E>
-Couple<K,E>::Couple(const Couple<K,E>& couple) {
-    key = couple.key;
-    element = couple.element;
-}
+Couple<K,E>::Couple(const Couple<K,E>& couple) : key(couple.key), element(couple.element) {}
+/**
+ * @brief Costruttore di spostamento: la chiave e l'elemento vengono spostati senza copiarli.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param couple coppia da spostare.
+ */
+template<class K, class E>
+Couple<K,E>::Couple(Couple<K,E>&& couple) : key(std::move(couple.key)), element(std::move(couple.element)) {}
 /**
  * @brief Costruttore che crea la coppia < K, E >.
  * @tparam K tipo della chiave.
@@ -52,10 +65,28 @@ Couple<K,E>::Couple(const Couple<K,E>& couple) {
  * @param e elemento.
  */
 template<class K, class E>
-Couple<K,E>::Couple(const K& k, const E& e) {
-    key = k;
-    element = e;
-}
+Couple<K,E>::Couple(const K& k, const E& e) : key(k), element(e) {}
+/**
+ * @brief Costruttore che crea la coppia < K, E > spostando la chiave e l'elemento.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param k chiave.
+ * @param e elemento.
+ */
+template<class K, class E>
+Couple<K,E>::Couple(K&& k, E&& e) : key(std::move(k)), element(std::move(e)) {}
+/**
+ * @brief Costruttore che crea la chiave a partire da k e costruisce l'elemento
+ * direttamente con gli argomenti args, senza oggetti temporanei.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param k chiave.
+ * @param args argomenti del costruttore dell'elemento.
+ */
+template<class K, class E>
+template<class K1, class... Args>
+Couple<K,E>::Couple(std::piecewise_construct_t, K1&& k, Args&&... args)
+        : key(std::forward<K1>(k)), element(std::forward<Args>(args)...) {}
 /**
  * @brief Restituisce la chiave della coppia.
  * @tparam K tipo della chiave.
@@ -63,7 +94,7 @@ Couple<K,E>::Couple(const K& k, const E& e) {
  * @return chiave della coppia.
  */
 template<class K, class E>
-const K Couple<K,E>::getKey() const {
+const K& Couple<K,E>::getKey() const {
     return key;
 }
 /**
@@ -73,7 +104,17 @@ const K Couple<K,E>::getKey() const {
  * @return elemento della coppia.
  */
 template<class K, class E>
-const E Couple<K,E>::getElement() const {
+const E& Couple<K,E>::getElement() const {
+    return element;
+}
+/**
+ * @brief Restituisce l'elemento della coppia, modificabile.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return elemento della coppia.
+ */
+template<class K, class E>
+E& Couple<K,E>::getElement() {
     return element;
 }
 /**
@@ -96,6 +137,16 @@ template<class K, class E>
 void Couple<K,E>::setElement(const E& e) {
     element = e;
 }
+/**
+ * @brief Imposta l'elemento della coppia spostandolo.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param e elemento da impostare.
+ */
+template<class K, class E>
+void Couple<K,E>::setElement(E&& e) {
+    element = std::move(e);
+}
 /**
  * @brief Operatore di uguaglianza.
  * @tparam K tipo della chiave.
@@ -122,6 +173,21 @@ Couple<K,E>& Couple<K,E>::operator=(const Couple<K,E>& couple) {
     }
     return *this;
 }
+/**
+ * @brief Operatore di assegnamento per spostamento.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param couple coppia da spostare.
+ * @return la coppia assegnata.
+ */
+template<class K, class E>
+Couple<K,E>& Couple<K,E>::operator=(Couple<K,E>&& couple) {
+    if (this != &couple) {
+        key = std::move(couple.key);
+        element = std::move(couple.element);
+    }
+    return *this;
+}
 /**
  * @brief Operatore di disuguaglianza.
  * @tparam K tipo della chiave.
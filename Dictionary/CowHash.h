@@ -0,0 +1,497 @@
+#ifndef DICTIONARY_COWHASH_H
+#define DICTIONARY_COWHASH_H
+
+#include "Dictionary.h"
+#include "Hash.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Classe che rappresenta un dizionario a indirizzamento aperto di cui si può
+ * fotografare il contenuto in tempo costante.
+ * Come in ClosedHash le collisioni sono risolte con sondaggio lineare, il bucket
+ * ideale si ottiene con l'hashing di Fibonacci e il numero di bucket è una potenza
+ * di 2; i bucket sono però divisi in pagine di PAGINA bucket, condivise tramite
+ * shared_ptr.
+ * <br>
+ * istantanea() e il costruttore di copia condividono l'intera tabella senza copiare
+ * nulla. La prima modifica successiva copia soltanto l'elenco delle pagine, e ogni
+ * pagina viene copiata alla prima scrittura che la riguarda: un'istantanea continua
+ * a vedere il contenuto del momento in cui è stata creata, mentre il dizionario paga
+ * la copia delle sole pagine che modifica.
+ * <br>
+ * Come ClosedHash, il dizionario non è protetto da accessi concorrenti: le modifiche
+ * e le chiamate a istantanea() devono provenire da un solo thread alla volta.
+ * Un'Istantanea invece è immutabile: più thread possono leggerla mentre il
+ * dizionario viene modificato, e può essere distrutta da qualunque thread.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam H funzione hash, per default Hash<K>.
+ */
+template <class K, class E, class H = Hash<K>>
+class CowHash : public Dictionary<K,E> {
+    struct Pagina;
+    struct Tabella;
+
+public:
+    typedef typename Dictionary<K,E>::Key Key;
+    typedef typename Dictionary<K,E>::Element Element;
+
+    /**
+     * @brief Vista immutabile del contenuto di un CowHash nel momento in cui è stata creata.
+     */
+    class Istantanea {
+    public:
+        bool dizionarioVuoto() const {return tabella->usati == 0;}
+        int lunghezza() const {return tabella->usati;}
+        Element recupera(const Key&) const;
+        bool appartiene(const Key& key) const {return find(key) != nullptr;}
+        const Couple<K,E>* find(const Key& key) const {return tabella->find(key, hash);}
+        bool tryGet(const Key&, Element&) const;
+        VectorList<K> keys() const {return tabella->keys();}
+        VectorList<E> values() const {return tabella->values();}
+
+    private:
+        friend class CowHash;
+        Istantanea(const std::shared_ptr<const Tabella>& tabella, const H& hash) : tabella(tabella), hash(hash) {}
+
+        std::shared_ptr<const Tabella> tabella;
+        H hash;
+    };
+
+    CowHash() : tabella(std::make_shared<Tabella>(PAGINA)) {}
+    CowHash(const CowHash& d) : tabella(d.tabella), hash(d.hash) {}
+
+    Istantanea istantanea() const {return Istantanea(tabella, hash);}
+
+    bool dizionarioVuoto() const {return tabella->usati == 0;}
+    void inserisci(const Couple<Key,Element>&);
+    void inserisci(Couple<Key,Element>&&);
+    void cancella(const Key&);
+    Element recupera(const Key&) const;
+    bool appartiene(const Key& key) const {return find(key) != nullptr;}
+    void aggiorna(const Key&, const Element&);
+
+    const Couple<K,E>* find(const Key& key) const {return tabella->find(key, hash);}
+    bool tryGet(const Key&, Element&) const;
+
+    void clear() {tabella = std::make_shared<Tabella>(PAGINA);}
+    int lunghezza() const {return tabella->usati;}
+    int capacita() const {return tabella->maxBuckets;}
+    VectorList<K> keys() const {return tabella->keys();}
+    VectorList<E> values() const {return tabella->values();}
+
+    CowHash& operator=(const CowHash&);
+
+private:
+    static constexpr int BIT_PAGINA = 6;
+    static constexpr int PAGINA = 1 << BIT_PAGINA;  // bucket per pagina, e dimensione minima della tabella
+    static const unsigned char VUOTO = 0;
+    static const unsigned char CANCELLATO = 1;
+    static const unsigned char OCCUPATO = 2;
+
+    /**
+     * @brief Pagina di PAGINA bucket: coppie memorizzate in linea e byte di controllo.
+     */
+    struct Pagina {
+        Pagina() {std::fill(stato, stato + PAGINA, static_cast<unsigned char>(VUOTO));}
+        Pagina(const Pagina&);
+        Pagina& operator=(const Pagina&) = delete;
+        ~Pagina();
+
+        Couple<K,E>* coppie() {return reinterpret_cast<Couple<K,E>*>(spazio);}
+        const Couple<K,E>* coppie() const {return reinterpret_cast<const Couple<K,E>*>(spazio);}
+
+        alignas(Couple<K,E>) unsigned char spazio[PAGINA * sizeof(Couple<K,E>)];
+        unsigned char stato[PAGINA];
+    };
+
+    /**
+     * @brief Elenco delle pagine di una tabella e relativi contatori. La copia
+     * condivide le pagine.
+     */
+    struct Tabella {
+        explicit Tabella(int);
+
+        const Pagina& pagina(int i) const {return *pagine[i >> BIT_PAGINA];}
+        int cerca(const Key&, const H&) const;
+        const Couple<K,E>* find(const Key&, const H&) const;
+        VectorList<K> keys() const;
+        VectorList<E> values() const;
+
+        std::vector<std::shared_ptr<Pagina>> pagine;
+        int maxBuckets;         // potenza di 2, multiplo di PAGINA
+        int bitIndice;          // log2(maxBuckets)
+        int usati;
+        int cancellati;
+    };
+
+    template <class T>
+    static bool esclusivo(const std::shared_ptr<T>&);
+    Tabella& tabellaScrivibile();
+    static Pagina& paginaScrivibile(Tabella&, int);
+    void posiziona(Couple<K,E>&&);
+    static void colloca(Tabella&, Couple<K,E>&&, const H&);
+    void ridimensiona();
+
+    std::shared_ptr<Tabella> tabella;
+    H hash;
+};
+/**
+ * @brief Costruttore di copia di una pagina: copia le coppie presenti.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param p pagina da copiare.
+ */
+template <class K, class E, class H>
+CowHash<K,E,H>::Pagina::Pagina(const Pagina& p) {
+    for (int s = 0; s < PAGINA; s++) {
+        if (p.stato[s] == OCCUPATO)
+            new (&coppie()[s]) Couple<K,E>(p.coppie()[s]);
+        stato[s] = p.stato[s];
+    }
+}
+/**
+ * @brief Distruttore di una pagina: distrugge le coppie presenti.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class H>
+CowHash<K,E,H>::Pagina::~Pagina() {
+    for (int s = 0; s < PAGINA; s++) {
+        if (stato[s] == OCCUPATO)
+            coppie()[s].~Couple<K,E>();
+    }
+}
+/**
+ * @brief Costruttore di una tabella vuota di dim bucket.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param dim numero di bucket, potenza di 2 non minore di PAGINA.
+ */
+template <class K, class E, class H>
+CowHash<K,E,H>::Tabella::Tabella(int dim) : maxBuckets(dim), bitIndice(0), usati(0), cancellati(0) {
+    while ((1 << bitIndice) < dim)
+        bitIndice++;
+    pagine.reserve(dim / PAGINA);
+    for (int p = 0; p < dim / PAGINA; p++)
+        pagine.push_back(std::make_shared<Pagina>());
+}
+/**
+ * @brief Metodo che individua il bucket della chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param hash funzione hash.
+ * @return indice del bucket che contiene la chiave key, -1 se la chiave non è presente.
+ */
+template <class K, class E, class H>
+int CowHash<K,E,H>::Tabella::cerca(const Key& key, const H& hash) const {
+    int i = static_cast<int>((uint64_t(hash(key)) * 0x9E3779B97F4A7C15ULL) >> (64 - bitIndice));
+    for (int n = 0; n < maxBuckets; n++) {
+        const Pagina& p = pagina(i);
+        unsigned char s = p.stato[i & (PAGINA - 1)];
+        if (s == VUOTO)
+            return -1;
+        if (s == OCCUPATO && p.coppie()[i & (PAGINA - 1)].getKey() == key)
+            return i;
+        i = (i + 1) & (maxBuckets - 1);
+    }
+    return -1;
+}
+/**
+ * @brief Metodo che restituisce un puntatore alla coppia con chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param hash funzione hash.
+ * @return puntatore alla coppia, nullptr se la chiave non è presente.
+ */
+template <class K, class E, class H>
+const Couple<K,E>* CowHash<K,E,H>::Tabella::find(const Key& key, const H& hash) const {
+    int i = cerca(key, hash);
+    return i == -1 ? nullptr : &pagina(i).coppie()[i & (PAGINA - 1)];
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutte le chiavi della tabella.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutte le chiavi della tabella.
+ */
+template <class K, class E, class H>
+VectorList<K> CowHash<K,E,H>::Tabella::keys() const {
+    VectorList<K> keys;
+    for (const std::shared_ptr<Pagina>& p : pagine) {
+        for (int s = 0; s < PAGINA; s++) {
+            if (p->stato[s] == OCCUPATO)
+                keys.inserisciCoda(p->coppie()[s].getKey());
+        }
+    }
+    return keys;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutti gli elementi della tabella.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutti gli elementi della tabella.
+ */
+template <class K, class E, class H>
+VectorList<E> CowHash<K,E,H>::Tabella::values() const {
+    VectorList<E> values;
+    for (const std::shared_ptr<Pagina>& p : pagine) {
+        for (int s = 0; s < PAGINA; s++) {
+            if (p->stato[s] == OCCUPATO)
+                values.inserisciCoda(p->coppie()[s].getElement());
+        }
+    }
+    return values;
+}
+/**
+ * @brief Metodo che recupera l'elemento associato alla chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return elemento associato alla chiave.
+ */
+template <class K, class E, class H>
+typename CowHash<K,E,H>::Element CowHash<K,E,H>::Istantanea::recupera(const Key& key) const {
+    const Couple<K,E>* c = find(key);
+    if (c == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    return c->getElement();
+}
+/**
+ * @brief Metodo che recupera l'elemento associato a key senza sollevare eccezioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param element riceve una copia dell'elemento, se la chiave è presente.
+ * @return true se la chiave è presente, false altrimenti.
+ */
+template <class K, class E, class H>
+bool CowHash<K,E,H>::Istantanea::tryGet(const Key& key, Element& element) const {
+    const Couple<K,E>* c = find(key);
+    if (c == nullptr)
+        return false;
+    element = c->getElement();
+    return true;
+}
+/**
+ * @brief Metodo che controlla se p è l'unico riferimento al proprio oggetto, che
+ * in tal caso si può modificare senza copiarlo.
+ * La barriera acquire rende visibili le letture compiute dai thread che hanno
+ * rilasciato gli altri riferimenti prima che l'oggetto venga modificato.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param p riferimento da controllare.
+ * @return true se l'oggetto non è condiviso, false altrimenti.
+ */
+template <class K, class E, class H>
+template <class T>
+bool CowHash<K,E,H>::esclusivo(const std::shared_ptr<T>& p) {
+    if (p.use_count() != 1)
+        return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+}
+/**
+ * @brief Metodo che restituisce la tabella, dopo averne copiato l'elenco delle
+ * pagine se è condivisa con una copia o un'istantanea.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return tabella modificabile.
+ */
+template <class K, class E, class H>
+typename CowHash<K,E,H>::Tabella& CowHash<K,E,H>::tabellaScrivibile() {
+    if (!esclusivo(tabella))
+        tabella = std::make_shared<Tabella>(*tabella);
+    return *tabella;
+}
+/**
+ * @brief Metodo che restituisce la pagina del bucket i di t, dopo averla copiata se
+ * è condivisa con un'altra tabella.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param t tabella modificabile.
+ * @param i indice di un bucket.
+ * @return pagina modificabile che contiene il bucket i.
+ */
+template <class K, class E, class H>
+typename CowHash<K,E,H>::Pagina& CowHash<K,E,H>::paginaScrivibile(Tabella& t, int i) {
+    std::shared_ptr<Pagina>& p = t.pagine[i >> BIT_PAGINA];
+    if (!esclusivo(p))
+        p = std::make_shared<Pagina>(*p);
+    return *p;
+}
+/**
+ * @brief Metodo che colloca in t una coppia la cui chiave non è presente, nel primo
+ * bucket libero o cancellato della sua sequenza di sondaggio.
+ * Non controlla il fattore di carico.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param t tabella modificabile.
+ * @param c coppia da collocare.
+ * @param hash funzione hash.
+ */
+template <class K, class E, class H>
+void CowHash<K,E,H>::colloca(Tabella& t, Couple<K,E>&& c, const H& hash) {
+    int i = static_cast<int>((uint64_t(hash(c.getKey())) * 0x9E3779B97F4A7C15ULL) >> (64 - t.bitIndice));
+    while (t.pagina(i).stato[i & (PAGINA - 1)] == OCCUPATO)
+        i = (i + 1) & (t.maxBuckets - 1);
+    Pagina& p = paginaScrivibile(t, i);
+    int s = i & (PAGINA - 1);
+    new (&p.coppie()[s]) Couple<K,E>(std::move(c));
+    if (p.stato[s] == CANCELLATO)
+        t.cancellati--;
+    p.stato[s] = OCCUPATO;
+    t.usati++;
+}
+/**
+ * @brief Metodo che inserisce una coppia la cui chiave non è presente, ricostruendo
+ * prima la tabella se il fattore di carico raggiunge 0.75.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia da inserire.
+ */
+template <class K, class E, class H>
+void CowHash<K,E,H>::posiziona(Couple<K,E>&& c) {
+    if ((double)(tabella->usati + tabella->cancellati + 1) > (double)tabella->maxBuckets * 0.75)
+        ridimensiona();
+    colloca(tabellaScrivibile(), std::move(c), hash);
+}
+/**
+ * @brief Metodo che ricostruisce la tabella senza bucket cancellati, con un numero
+ * di bucket tale da riportare il fattore di carico al più a 0.5.
+ * Le coppie delle pagine non condivise vengono spostate, le altre copiate: le
+ * istantanee conservano la vecchia tabella.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class H>
+void CowHash<K,E,H>::ridimensiona() {
+    int dim = PAGINA;
+    while ((double)dim * 0.5 < (double)(tabella->usati + 1))
+        dim *= 2;
+    std::shared_ptr<Tabella> nuova = std::make_shared<Tabella>(dim);
+    bool propria = esclusivo(tabella);
+    for (std::shared_ptr<Pagina>& p : tabella->pagine) {
+        bool sposta = propria && esclusivo(p);
+        for (int s = 0; s < PAGINA; s++) {
+            if (p->stato[s] != OCCUPATO)
+                continue;
+            if (sposta)
+                colloca(*nuova, std::move(p->coppie()[s]), hash);
+            else
+                colloca(*nuova, Couple<K,E>(p->coppie()[s]), hash);
+        }
+    }
+    tabella = std::move(nuova);
+}
+/**
+ * @brief Metodo che inserisce una coppia nel dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia da inserire.
+ */
+template <class K, class E, class H>
+void CowHash<K,E,H>::inserisci(const Couple<Key,Element>& c) {
+    inserisci(Couple<K,E>(c));
+}
+/**
+ * @brief Metodo che inserisce una coppia nel dizionario spostandola, senza copiarla.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia da spostare nel dizionario.
+ */
+template <class K, class E, class H>
+void CowHash<K,E,H>::inserisci(Couple<Key,Element>&& c) {
+    if (tabella->cerca(c.getKey(), hash) != -1)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+    posiziona(std::move(c));
+}
+/**
+ * @brief Metodo che cancella la coppia con chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia da cancellare.
+ */
+template <class K, class E, class H>
+void CowHash<K,E,H>::cancella(const Key& key) {
+    if (tabella->usati == 0)
+        throw std::out_of_range("Il dizionario è vuoto.");
+    int i = tabella->cerca(key, hash);
+    if (i == -1)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    Tabella& t = tabellaScrivibile();
+    Pagina& p = paginaScrivibile(t, i);
+    p.coppie()[i & (PAGINA - 1)].~Couple<K,E>();
+    p.stato[i & (PAGINA - 1)] = CANCELLATO;
+    t.usati--;
+    t.cancellati++;
+}
+/**
+ * @brief Metodo che recupera l'elemento associato alla chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return elemento associato alla chiave.
+ */
+template <class K, class E, class H>
+typename CowHash<K,E,H>::Element CowHash<K,E,H>::recupera(const Key& key) const {
+    const Couple<K,E>* c = find(key);
+    if (c == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    return c->getElement();
+}
+/**
+ * @brief Metodo che aggiorna l'elemento associato alla chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia da aggiornare.
+ * @param element nuovo elemento.
+ */
+template <class K, class E, class H>
+void CowHash<K,E,H>::aggiorna(const Key& key, const Element& element) {
+    int i = tabella->cerca(key, hash);
+    if (i == -1)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    Pagina& p = paginaScrivibile(tabellaScrivibile(), i);
+    p.coppie()[i & (PAGINA - 1)].setElement(element);
+}
+/**
+ * @brief Metodo che recupera l'elemento associato a key senza sollevare eccezioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param element riceve una copia dell'elemento, se la chiave è presente.
+ * @return true se la chiave è presente, false altrimenti.
+ */
+template <class K, class E, class H>
+bool CowHash<K,E,H>::tryGet(const Key& key, Element& element) const {
+    const Couple<K,E>* c = find(key);
+    if (c == nullptr)
+        return false;
+    element = c->getElement();
+    return true;
+}
+/**
+ * @brief Operatore di assegnamento: come la copia, condivide la tabella di d.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param d dizionario da assegnare.
+ * @return riferimento al dizionario.
+ */
+template <class K, class E, class H>
+CowHash<K,E,H>& CowHash<K,E,H>::operator=(const CowHash& d) {
+    tabella = d.tabella;
+    hash = d.hash;
+    return *this;
+}
+
+#endif //DICTIONARY_COWHASH_H
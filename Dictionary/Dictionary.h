@@ -4,6 +4,23 @@
 #include "Couple.h"
 #include "../List/VectorList.h"
 
+/**
+ * @brief Classe che rappresenta un intervallo [begin, end) di iteratori, utilizzabile
+ * in un ciclo for basato su intervallo senza copiare gli elementi.
+ * @tparam It tipo dell'iteratore.
+ */
+template <class It>
+class Intervallo {
+public:
+    Intervallo(It inizio, It fine) : inizio(inizio), fine(fine) {}
+    It begin() const {return inizio;}
+    It end() const {return fine;}
+
+private:
+    It inizio;
+    It fine;
+};
+
 /**
  * @brief Interfaccia che rappresenta un dizionario.
  * Un dizionario è una collezione di elementi, ognuno dei quali è identificato da una chiave.
@@ -20,9 +37,11 @@ public:
     typedef E Element;
 
     // virtual void create() = 0; Rimpiazzato dal costruttore
+    virtual ~Dictionary() = default;                        // distruzione tramite puntatore all'interfaccia
 
     virtual bool dizionarioVuoto() const = 0;
-    virtual void inserisci(Couple<Key,Element>&) = 0;
+    virtual void inserisci(const Couple<Key,Element>&) = 0;
+    virtual void inserisci(Couple<Key,Element>&&) = 0;     // sposta la coppia nel dizionario
     virtual void cancella(const Key&) = 0;
     virtual Element recupera(const Key&) const = 0;
     virtual bool appartiene(const Key&) const = 0;
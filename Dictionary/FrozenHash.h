@@ -0,0 +1,339 @@
+#ifndef DICTIONARY_FROZENHASH_H
+#define DICTIONARY_FROZENHASH_H
+
+#include "ClosedHash.h"
+#include "Dictionary.h"
+#include "Hash.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Classe che rappresenta un dizionario immutabile basato su una funzione hash
+ * perfetta minima (schema "hash and displace", come CHD e PTHash).
+ * Le n coppie sono memorizzate in un array di esattamente n posizioni, senza bucket
+ * liberi. Le chiavi sono ripartite in circa n / CHIAVI_PER_GRUPPO gruppi; per ogni
+ * gruppo viene scelto alla costruzione un pilota, cioè un intero che, combinato con
+ * l'hash di ciascuna chiave del gruppo, le assegna posizioni libere e distinte.
+ * I gruppi vengono sistemati dal più numeroso al meno numeroso, quando le posizioni
+ * libere sono ancora molte.
+ * <br>
+ * Come in PTHash, i piloti assegnano posizioni in un intervallo di n / FATTORE_CARICO
+ * posizioni, leggermente più ampio di n: anche gli ultimi gruppi trovano così un
+ * pilota in pochi tentativi. Le coppie finite oltre la posizione n vengono poi
+ * rimappate sulle posizioni rimaste libere in [0, n). Se un gruppo non trova un
+ * pilota entro MAX_TENTATIVI tentativi, la costruzione riparte con un altro seme
+ * per la funzione hash.
+ * <br>
+ * Una ricerca legge il pilota del gruppo della chiave, calcola la posizione ed
+ * eventualmente la rimappa, poi confronta la chiave memorizzata in quella posizione:
+ * un solo accesso alle coppie, senza sondaggio. Una chiave assente viene
+ * riconosciuta dal confronto.
+ * <br>
+ * Il dizionario offre solo le operazioni di lettura di Dictionary: recupera(),
+ * appartiene(), keys() e values().
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam H funzione hash, per default Hash<K>.
+ */
+template <class K, class E, class H = Hash<K>>
+class FrozenHash {
+public:
+    typedef K Key;
+    typedef E Element;
+
+    template<class H1, class A1>
+    explicit FrozenHash(const ClosedHash<K,E,H1,A1>&);
+    explicit FrozenHash(const VectorList<Couple<K,E>>&);
+
+    bool dizionarioVuoto() const {return numCoppie == 0;}
+    int lunghezza() const {return numCoppie;}
+    Element recupera(const Key&) const;
+    bool appartiene(const Key&) const;
+    const Couple<K,E>* find(const Key&) const;
+    bool tryGet(const Key&, Element&) const;
+    VectorList<K> keys() const;
+    VectorList<E> values() const;
+
+private:
+    static const int CHIAVI_PER_GRUPPO = 3;
+    static constexpr double FATTORE_CARICO = 0.97;
+    static const uint32_t MAX_TENTATIVI = 1 << 16;     // piloti provati per gruppo prima di cambiare seme
+    static const uint64_t MAX_SEMI = 64;
+
+    void costruisci(const std::vector<const Couple<K,E>*>&);
+    bool sistema(const std::vector<const Couple<K,E>*>&, std::vector<int>&);
+    static int riduci(uint64_t h, int n) {return static_cast<int>(((h >> 32) * uint64_t(n)) >> 32);}
+    uint64_t calcHash(const Key& key) const {return HashBase::mescola(uint64_t(hash(key)) ^ seme);}
+    int gruppo(uint64_t h) const {return riduci(h, numGruppi);}
+    int posizione(uint64_t h, uint32_t pilota) const {
+        return riduci(HashBase::mescola(h ^ (uint64_t(pilota) * 0x9E3779B97F4A7C15ULL)), numPosizioni);
+    }
+    int cercaSlot(const Key&) const;
+
+    std::vector<Couple<K,E>> coppie;    // una coppia per posizione, nessuna posizione libera
+    std::vector<uint32_t> piloti;       // un pilota per gruppo
+    std::vector<int> rimappa;           // per ogni posizione p >= n, la posizione in [0, n) che la sostituisce
+    int numCoppie;
+    int numGruppi;
+    int numPosizioni;                   // ampiezza dell'intervallo in cui i piloti assegnano le posizioni
+    uint64_t seme;
+    H hash;
+};
+/**
+ * @brief Costruttore che congela le coppie di un ClosedHash.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param dizionario dizionario da cui copiare le coppie.
+ */
+template <class K, class E, class H>
+template <class H1, class A1>
+FrozenHash<K,E,H>::FrozenHash(const ClosedHash<K,E,H1,A1>& dizionario) {
+    std::vector<const Couple<K,E>*> sorgenti;
+    sorgenti.reserve(dizionario.lunghezza());
+    for (const Couple<K,E>& c : dizionario)
+        sorgenti.push_back(&c);
+    costruisci(sorgenti);
+}
+/**
+ * @brief Costruttore che congela una lista di coppie.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param lista lista di coppie con chiavi distinte.
+ */
+template <class K, class E, class H>
+FrozenHash<K,E,H>::FrozenHash(const VectorList<Couple<K,E>>& lista) {
+    std::vector<Couple<K,E>> copie;
+    copie.reserve(lista.lunghezza());
+    for (int p = 1; p <= lista.lunghezza(); p++)
+        copie.push_back(lista.leggiLista(p));
+    std::vector<const Couple<K,E>*> sorgenti;
+    sorgenti.reserve(copie.size());
+    for (const Couple<K,E>& c : copie)
+        sorgenti.push_back(&c);
+    costruisci(sorgenti);
+}
+/**
+ * @brief Metodo che calcola i piloti e dispone le coppie nelle posizioni assegnate.
+ * Se per il seme corrente un gruppo non trova un pilota, la costruzione viene
+ * ripetuta con il seme successivo.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param sorgenti coppie da inserire.
+ */
+template <class K, class E, class H>
+void FrozenHash<K,E,H>::costruisci(const std::vector<const Couple<K,E>*>& sorgenti) {
+    int n = static_cast<int>(sorgenti.size());
+    numCoppie = n;
+    numGruppi = n / CHIAVI_PER_GRUPPO + 1;
+    numPosizioni = static_cast<int>(n / FATTORE_CARICO) + 1;
+    std::vector<int> ordine;    // per ogni posizione, l'indice della coppia in sorgenti
+    seme = 0;
+    while (!sistema(sorgenti, ordine)) {
+        if (++seme == MAX_SEMI)
+            throw std::runtime_error("Error: impossibile costruire la funzione hash perfetta.");
+    }
+
+    // Le coppie oltre la posizione n occupano le posizioni rimaste libere in [0, n)
+    rimappa.assign(numPosizioni - n, 0);
+    int libera = 0;
+    for (int p = n; p < numPosizioni; p++) {
+        if (ordine[p] == -1)
+            continue;
+        while (ordine[libera] != -1)
+            libera++;
+        ordine[libera] = ordine[p];
+        rimappa[p - n] = libera;
+    }
+
+    coppie.reserve(n);
+    for (int s = 0; s < n; s++)
+        coppie.push_back(*sorgenti[ordine[s]]);
+}
+/**
+ * @brief Metodo che cerca i piloti di tutti i gruppi con il seme corrente.
+ * Due chiavi distinte con lo stesso hash non possono essere separate da alcun pilota
+ * né da alcun seme: in tal caso viene sollevata un'eccezione.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param sorgenti coppie da inserire.
+ * @param ordine riceve, per ogni posizione, l'indice della coppia in sorgenti o -1.
+ * @return true se ogni gruppo ha trovato un pilota, false altrimenti.
+ */
+template <class K, class E, class H>
+bool FrozenHash<K,E,H>::sistema(const std::vector<const Couple<K,E>*>& sorgenti, std::vector<int>& ordine) {
+    int n = numCoppie;
+    std::vector<uint64_t> hashes(n);
+
+    // Ripartizione in gruppi con un counting sort sull'indice del gruppo
+    std::vector<int> inizio(numGruppi + 1, 0);
+    for (int i = 0; i < n; i++) {
+        hashes[i] = calcHash(sorgenti[i]->getKey());
+        inizio[gruppo(hashes[i]) + 1]++;
+    }
+    int massimo = 0;
+    for (int g = 0; g < numGruppi; g++) {
+        massimo = std::max(massimo, inizio[g + 1]);
+        inizio[g + 1] += inizio[g];
+    }
+    std::vector<int> membri(n);
+    std::vector<int> riempimento(inizio.begin(), inizio.end() - 1);
+    for (int i = 0; i < n; i++)
+        membri[riempimento[gruppo(hashes[i])]++] = i;
+
+    // Gruppi in ordine di dimensione decrescente, ancora con un counting sort
+    std::vector<int> perDimensione(massimo + 2, 0);
+    for (int g = 0; g < numGruppi; g++)
+        perDimensione[massimo - (inizio[g + 1] - inizio[g]) + 1]++;
+    for (int d = 0; d <= massimo; d++)
+        perDimensione[d + 1] += perDimensione[d];
+    std::vector<int> gruppi(numGruppi);
+    for (int g = 0; g < numGruppi; g++)
+        gruppi[perDimensione[massimo - (inizio[g + 1] - inizio[g])]++] = g;
+
+    piloti.assign(numGruppi, 0);
+    ordine.assign(numPosizioni, -1);
+    std::vector<bool> occupate(numPosizioni, false);    // bitmap compatta, consultata a ogni tentativo
+    std::vector<int> posizioni;
+    for (int g : gruppi) {
+        int primo = inizio[g], ultimo = inizio[g + 1];
+        if (primo == ultimo)
+            break;  // da qui in poi tutti i gruppi sono vuoti
+
+        for (int a = primo; a < ultimo; a++) {
+            for (int b = a + 1; b < ultimo; b++) {
+                if (hashes[membri[a]] != hashes[membri[b]])
+                    continue;
+                if (sorgenti[membri[a]]->getKey() == sorgenti[membri[b]]->getKey())
+                    throw std::invalid_argument("Error: la lista contiene chiavi duplicate.");
+                throw std::invalid_argument("Error: due chiavi distinte hanno lo stesso hash.");
+            }
+        }
+
+        // Cerca il primo pilota che assegna a tutto il gruppo posizioni libere e distinte
+        for (uint32_t pilota = 0; ; pilota++) {
+            if (pilota == MAX_TENTATIVI)
+                return false;
+            posizioni.clear();
+            bool libero = true;
+            for (int a = primo; a < ultimo && libero; a++) {
+                int s = posizione(hashes[membri[a]], pilota);
+                if (occupate[s]) {
+                    libero = false;
+                } else {
+                    occupate[s] = true;
+                    posizioni.push_back(s);
+                }
+            }
+            if (libero) {
+                piloti[g] = pilota;
+                for (int a = primo; a < ultimo; a++)
+                    ordine[posizioni[a - primo]] = membri[a];
+                break;
+            }
+            for (int s : posizioni)
+                occupate[s] = false;
+        }
+    }
+    return true;
+}
+/**
+ * @brief Metodo che individua la posizione della chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return posizione della coppia con chiave key, -1 se la chiave non è presente.
+ */
+template <class K, class E, class H>
+int FrozenHash<K,E,H>::cercaSlot(const Key& key) const {
+    if (numCoppie == 0)
+        return -1;
+    uint64_t h = calcHash(key);
+    int s = posizione(h, piloti[gruppo(h)]);
+    if (s >= numCoppie)
+        s = rimappa[s - numCoppie];
+    return coppie[s].getKey() == key ? s : -1;
+}
+/**
+ * @brief Metodo che recupera l'elemento associato alla chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return elemento associato alla chiave.
+ */
+template <class K, class E, class H>
+typename FrozenHash<K,E,H>::Element FrozenHash<K,E,H>::recupera(const Key& key) const {
+    int s = cercaSlot(key);
+    if (s == -1)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    return coppie[s].getElement();
+}
+/**
+ * @brief Metodo che controlla se la chiave key è presente nel dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return true se la chiave è presente, false altrimenti.
+ */
+template <class K, class E, class H>
+bool FrozenHash<K,E,H>::appartiene(const Key& key) const {
+    return cercaSlot(key) != -1;
+}
+/**
+ * @brief Metodo che restituisce un puntatore alla coppia con chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia, nullptr se la chiave non è presente.
+ */
+template <class K, class E, class H>
+const Couple<K,E>* FrozenHash<K,E,H>::find(const Key& key) const {
+    int s = cercaSlot(key);
+    return s == -1 ? nullptr : &coppie[s];
+}
+/**
+ * @brief Metodo che recupera l'elemento associato a key senza sollevare eccezioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param element riceve una copia dell'elemento, se la chiave è presente.
+ * @return true se la chiave è presente, false altrimenti.
+ */
+template <class K, class E, class H>
+bool FrozenHash<K,E,H>::tryGet(const Key& key, Element& element) const {
+    int s = cercaSlot(key);
+    if (s == -1)
+        return false;
+    element = coppie[s].getElement();
+    return true;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutte le chiavi del dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutte le chiavi del dizionario.
+ */
+template <class K, class E, class H>
+VectorList<K> FrozenHash<K,E,H>::keys() const {
+    VectorList<K> keys;
+    for (const Couple<K,E>& c : coppie)
+        keys.inserisciCoda(c.getKey());
+    return keys;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutti gli elementi del dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutti gli elementi del dizionario.
+ */
+template <class K, class E, class H>
+VectorList<E> FrozenHash<K,E,H>::values() const {
+    VectorList<E> values;
+    for (const Couple<K,E>& c : coppie)
+        values.inserisciCoda(c.getElement());
+    return values;
+}
+
+#endif //DICTIONARY_FROZENHASH_H
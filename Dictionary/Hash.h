@@ -1,15 +1,128 @@
 #ifndef DICTIONARY_HASH_H
 #define DICTIONARY_HASH_H
 
+#include <cstdint>
+#include <cstring>
+#include <random>
 #include <string>
+#include <string_view>
+#include <type_traits>
 using std::string;
 
+/**
+ * @brief Funzioni di supporto comuni alle funzioni hash.
+ * <br>
+ * mescola() è il finalizzatore di MurmurHash3: una biiezione su 64 bit in cui ogni
+ * bit in ingresso influenza tutti i bit in uscita, così che anche chiavi consecutive
+ * producano indici ben distribuiti sia nei bit alti sia nei bit bassi.
+ * <br>
+ * hashBytes() è una funzione hash per sequenze di byte nello stile di wyhash: legge
+ * la sequenza 16 byte per passo (48 byte per passo, su tre catene indipendenti,
+ * per le sequenze più lunghe) e combina ogni blocco con una moltiplicazione
+ * 64 x 64 -> 128 bit.
+ */
+class HashBase {
+public:
+    static uint64_t mescola(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    static uint64_t hashBytes(const void* key, size_t len, uint64_t seed) {
+        const unsigned char* p = static_cast<const unsigned char*>(key);
+        uint64_t a, b;
+        seed ^= mix(seed ^ SEGRETO[0], SEGRETO[1]);
+        if (len <= 16) {
+            if (len >= 4) {
+                a = (leggi4(p) << 32) | leggi4(p + ((len >> 3) << 2));
+                b = (leggi4(p + len - 4) << 32) | leggi4(p + len - 4 - ((len >> 3) << 2));
+            } else if (len > 0) {
+                a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+                b = 0;
+            } else {
+                a = b = 0;
+            }
+        } else {
+            size_t i = len;
+            if (i > 48) {
+                uint64_t seme1 = seed, seme2 = seed;
+                do {
+                    seed = mix(leggi8(p) ^ SEGRETO[1], leggi8(p + 8) ^ seed);
+                    seme1 = mix(leggi8(p + 16) ^ SEGRETO[2], leggi8(p + 24) ^ seme1);
+                    seme2 = mix(leggi8(p + 32) ^ SEGRETO[3], leggi8(p + 40) ^ seme2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                seed ^= seme1 ^ seme2;
+            }
+            while (i > 16) {
+                seed = mix(leggi8(p) ^ SEGRETO[1], leggi8(p + 8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+            a = leggi8(p + i - 16);
+            b = leggi8(p + i - 8);
+        }
+        a ^= SEGRETO[1];
+        b ^= seed;
+        moltiplica(a, b);
+        return mix(a ^ SEGRETO[0] ^ len, b ^ SEGRETO[1]);
+    }
+
+    static uint64_t semeProcesso() {
+        static const uint64_t seme = (uint64_t(std::random_device()()) << 32) ^ std::random_device()();
+        return seme;
+    }
+
+private:
+    static constexpr uint64_t SEGRETO[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+                                            0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+    // Moltiplicazione 64 x 64 -> 128 bit: a riceve la metà bassa, b quella alta
+    static void moltiplica(uint64_t& a, uint64_t& b) {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t r = (__uint128_t)a * b;
+        a = (uint64_t)r;
+        b = (uint64_t)(r >> 64);
+#else
+        uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t)a, lb = (uint32_t)b;
+        uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        uint64_t t = rl + (rm0 << 32), c = t < rl;
+        uint64_t lo = t + (rm1 << 32);
+        c += lo < t;
+        a = lo;
+        b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+    }
+    static uint64_t mix(uint64_t a, uint64_t b) {
+        moltiplica(a, b);
+        return a ^ b;
+    }
+    static uint64_t leggi8(const unsigned char* p) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+    static uint64_t leggi4(const unsigned char* p) {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+};
+
 /**
  * @brief Classe che implementa una funzione di hash generica.
  * La funzione hash è definita come un operatore di chiamata ().
  * Prende un valore "key" e restituisce un valore "size_t" che rappresenta
  * il valore hash calcolato per la chiave.
  * <br>
+ * Il valore della chiave, convertito in intero, viene rimescolato con
+ * HashBase::mescola, così che chiavi consecutive non finiscano in bucket consecutivi.
+ * <br>
  * Questa definizione può essere utilizzata come base per una funzione di hash
  * specializzata per un particolare tipo di dato.
  * @tparam T
@@ -17,39 +130,89 @@ using std::string;
 template <class T>
 class Hash {
 public:
-    size_t operator()(const T key) const {
-        return size_t(key);
+    size_t operator()(const T& key) const {
+        return size_t(HashBase::mescola(uint64_t(key)));
     }
 };
 /**
  * @brief Classe che implementa una specializzazione parziale del template Hash per il tipo string.
+ * La funzione è trasparente: string, string_view e const char* con gli stessi
+ * caratteri producono lo stesso hash, così che i dizionari con chiavi string possano
+ * essere interrogati senza costruire una string temporanea.
  */
 template<>
 class Hash<string> {
 public:
+    typedef void is_transparent;
+
     /**
      * @brief Funzione hash per il tipo string.
      * La funzione hash è definita come un operatore di chiamata ().
      * Prende una stringa "key" e restituisce un valore "size_t" che rappresenta
      * il valore hash calcolato per la stringa.
      * <br>
-     * All'interno della funzione hash, viene utilizzato l'algoritmo di hashing denominato
-     * "polynomial rolling hash". Viene calcolato un valore hash per la stringa iterando
-     * attraverso tutto i suoi caratteri. Il valore di hash viene calcolato moltiplicando
-     * il valore hash precedente per 5 e aggiungendo il valore ASCII del carattere corrente
-     * utilizzando la funzione key.at(i).
-     * <br>
-     * Infine, il valore hash calcolato viene convertito in size_t e restituito.
+     * La stringa viene elaborata a blocchi di 16 byte con HashBase::hashBytes,
+     * senza copiarla e senza controlli sui singoli caratteri.
      * @param key
      * @return
      */
-    size_t operator()(const string key) const {
-        unsigned long hashValue = 0;
-        int length = (int) key.length();
-        for (int i = 0; i < length; i++)
-            hashValue = 5 * hashValue + key.at(i);
-        return size_t(hashValue);
+    size_t operator()(std::string_view key) const {
+        return size_t(HashBase::hashBytes(key.data(), key.size(), 0));
     }
 };
+/**
+ * @brief Classe che implementa una funzione di hash con seme.
+ * A parità di chiave, semi diversi producono valori hash indipendenti: scegliendo
+ * il seme a caso non è possibile costruire in anticipo chiavi che collidono.
+ * Il costruttore di default usa un seme casuale, generato una sola volta per processo.
+ * @tparam T tipo della chiave.
+ */
+template <class T>
+class HashSeeded {
+public:
+    HashSeeded() : seme(HashBase::semeProcesso()) {}
+    explicit HashSeeded(uint64_t s) : seme(s) {}
+
+    size_t operator()(const T& key) const {
+        uint64_t v = uint64_t(key);
+        return size_t(HashBase::hashBytes(&v, sizeof(v), seme));
+    }
+
+private:
+    uint64_t seme;
+};
+/**
+ * @brief Specializzazione di HashSeeded per il tipo string, trasparente come Hash<string>.
+ */
+template<>
+class HashSeeded<string> {
+public:
+    typedef void is_transparent;
+
+    HashSeeded() : seme(HashBase::semeProcesso()) {}
+    explicit HashSeeded(uint64_t s) : seme(s) {}
+
+    size_t operator()(std::string_view key) const {
+        return size_t(HashBase::hashBytes(key.data(), key.size(), seme));
+    }
+
+private:
+    uint64_t seme;
+};
+/**
+ * @brief Vale true se la funzione hash H dichiara is_transparent, cioè se calcola lo
+ * stesso hash per la chiave e per i tipi equivalenti (per esempio string e string_view).
+ * @tparam H funzione hash.
+ */
+template <class H, class = void>
+struct HashTrasparente : std::false_type {};
+template <class H>
+struct HashTrasparente<H, std::void_t<typename H::is_transparent>> : std::true_type {};
+/**
+ * @brief Abilita le ricerche con una chiave di tipo Q in un dizionario con chiavi K e
+ * funzione hash H: sempre se Q coincide con K, altrimenti solo se H è trasparente.
+ */
+template <class H, class Q, class K>
+using ChiaveTrasparente = typename std::enable_if<std::is_same<Q, K>::value || HashTrasparente<H>::value>::type;
 
 #endif //DICTIONARY_HASH_H
@@ -0,0 +1,651 @@
+#ifndef DICTIONARY_LOCKFREEHASH_H
+#define DICTIONARY_LOCKFREEHASH_H
+
+#include "Dictionary.h"
+#include "Hash.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Classe che rappresenta un dizionario con hash chiuso in cui le letture non
+ * acquisiscono mai lock.
+ * Ogni bucket è un puntatore atomico a una coppia immutabile: recupera(), appartiene()
+ * e tryGet() percorrono la sequenza di sondaggio con sole letture atomiche. Le
+ * scritture sono serializzate da un mutex e pubblicano le modifiche con scritture
+ * atomiche dei bucket: aggiorna() sostituisce la coppia con una nuova, cancella()
+ * sostituisce il puntatore con un marcatore di cancellazione.
+ * <br>
+ * Le coppie rimosse vengono liberate con una reclamazione a epoche: un lettore
+ * dichiara l'epoca in cui entra incrementando un contatore (ripartito su più linee
+ * di cache per evitare contese) e lo decrementa all'uscita; uno scrittore libera le
+ * coppie rimosse solo dopo aver fatto avanzare l'epoca e atteso che i lettori
+ * dell'epoca precedente siano usciti. I lettori non attendono mai.
+ * <br>
+ * Il ridimensionamento è incrementale: la nuova tabella viene collegata a quella
+ * corrente e ogni scrittura vi trasferisce un numero limitato di bucket, marcando
+ * come spostati quelli di origine. Durante il trasferimento i lettori cercano prima
+ * nella tabella corrente e poi in quella nuova, senza mai attendere.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam H funzione hash, per default Hash<K>.
+ */
+template <class K, class E, class H = Hash<K>>
+class LockFreeHash : public Dictionary<K,E> {
+public:
+    typedef typename Dictionary<K,E>::Key Key;
+    typedef typename Dictionary<K,E>::Element Element;
+
+    LockFreeHash();
+    LockFreeHash(int);
+    LockFreeHash(const LockFreeHash&) = delete;
+    LockFreeHash& operator=(const LockFreeHash&) = delete;
+    ~LockFreeHash();
+
+    bool dizionarioVuoto() const;
+    void inserisci(const Couple<Key,Element>&);
+    void inserisci(Couple<Key,Element>&&);
+    void cancella(const Key&);
+    Element recupera(const Key&) const;
+    bool appartiene(const Key&) const;
+    void aggiorna(const Key&, const Element&);
+
+    bool tryGet(const Key&, Element&) const;
+    template<class E1>
+    bool insert_or_assign(const Key&, E1&&);
+
+    void clear();
+    int lunghezza() const {return numElementi.load(std::memory_order_relaxed);}
+    VectorList<K> keys() const;
+    VectorList<E> values() const;
+
+private:
+    static const int STRISCE = 64;          // contatori dei lettori, uno per linea di cache
+    static const int PASSO = 64;            // bucket trasferiti da ogni scrittura durante il ridimensionamento
+    static const int RITIRATI_MAX = 256;    // coppie rimosse oltre le quali si liberano
+
+    struct Tabella {
+        explicit Tabella(int);
+        ~Tabella();
+        int dim;                                // numero di bucket, potenza di 2
+        int bitIndice;                          // log2(dim)
+        std::atomic<Couple<K,E>*>* slot;        // coppie o marcatori
+        std::atomic<Tabella*> nuova;            // tabella in cui si sta trasferendo, se presente
+        int usati;                              // coppie presenti (solo scrittori)
+        int cancellati;                         // bucket cancellati (solo scrittori)
+    };
+
+    struct alignas(64) Striscia {
+        std::atomic<int> attivi[2];             // lettori attivi per parità di epoca
+    };
+
+    // Sezione di lettura: registra il lettore nell'epoca corrente per tutta la sua durata
+    class SezioneLettura {
+    public:
+        explicit SezioneLettura(const LockFreeHash&);
+        ~SezioneLettura();
+    private:
+        std::atomic<int>& contatore;
+        static std::atomic<int>& entra(const LockFreeHash&);
+    };
+
+    static Couple<K,E>* cancellato() {return reinterpret_cast<Couple<K,E>*>(uintptr_t(1));}
+    static Couple<K,E>* spostato() {return reinterpret_cast<Couple<K,E>*>(uintptr_t(2));}
+    static bool valida(Couple<K,E>* c) {return reinterpret_cast<uintptr_t>(c) > 2;}
+    static int striscia();
+
+    int calcHome(size_t, const Tabella*) const;
+    Couple<K,E>* cerca(const Key&) const;
+    std::atomic<Couple<K,E>*>* cercaSlot(const Key&, Tabella*&) const;
+    void inserisciNodo(Tabella*, Couple<K,E>*);
+    void inserisciCoppia(Couple<K,E>*);
+    void passoTrasferimento();
+    void ritira(Couple<K,E>*);
+    void sincronizza();
+    void liberaTabella(Tabella*);
+
+    std::atomic<Tabella*> corrente;     // tabella da cui partono le ricerche
+    int trasferiti;                     // bucket della tabella corrente già trasferiti
+    std::atomic<int> numElementi;
+    std::atomic<uint64_t> epoca;
+    mutable Striscia strisce[STRISCE];
+    std::vector<Couple<K,E>*> coppieRitirate;
+    std::vector<Tabella*> tabelleRitirate;
+    mutable std::mutex scrittura;       // serializza gli scrittori
+    H hash;
+};
+/**
+ * @brief Costruttore di default che inizializza un dizionario con 32 bucket.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+LockFreeHash<K,E,H>::LockFreeHash() : LockFreeHash(32) {}
+/**
+ * @brief Costruttore che inizializza un dizionario con un numero di bucket pari alla
+ * potenza di 2 maggiore o uguale a n (almeno 8).
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param n numero di bucket.
+ */
+template<class K, class E, class H>
+LockFreeHash<K,E,H>::LockFreeHash(int n) : trasferiti(0), numElementi(0), epoca(0) {
+    if (n <= 0)
+        throw std::invalid_argument("Error: il numero di bucket deve essere positivo.");
+    int dim = 8;
+    while (dim < n)
+        dim *= 2;
+    for (int i = 0; i < STRISCE; i++) {
+        strisce[i].attivi[0].store(0, std::memory_order_relaxed);
+        strisce[i].attivi[1].store(0, std::memory_order_relaxed);
+    }
+    corrente.store(new Tabella(dim), std::memory_order_release);
+}
+/**
+ * @brief Distruttore. Non devono esserci letture o scritture in corso.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+LockFreeHash<K,E,H>::~LockFreeHash() {
+    liberaTabella(corrente.load(std::memory_order_relaxed));
+    for (Couple<K,E>* c : coppieRitirate)
+        delete c;
+    for (Tabella* t : tabelleRitirate)
+        delete t;
+}
+/**
+ * @brief Metodo che controlla se il dizionario è vuoto.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return true se il dizionario è vuoto, false altrimenti.
+ */
+template<class K, class E, class H>
+bool LockFreeHash<K,E,H>::dizionarioVuoto() const {
+    return lunghezza() == 0;
+}
+/**
+ * @brief Metodo che inserisce una copia della coppia < K, E > nel dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param couple coppia da inserire.
+ */
+template<class K, class E, class H>
+void LockFreeHash<K,E,H>::inserisci(const Couple<Key,Element>& couple) {
+    std::lock_guard<std::mutex> guardia(scrittura);
+    passoTrasferimento();
+    Tabella* t;
+    if (cercaSlot(couple.getKey(), t) != nullptr)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+    inserisciCoppia(new Couple<K,E>(couple));
+}
+/**
+ * @brief Metodo che inserisce una coppia < K, E > nel dizionario spostandola.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param couple coppia da spostare nel dizionario.
+ */
+template<class K, class E, class H>
+void LockFreeHash<K,E,H>::inserisci(Couple<Key,Element>&& couple) {
+    std::lock_guard<std::mutex> guardia(scrittura);
+    passoTrasferimento();
+    Tabella* t;
+    if (cercaSlot(couple.getKey(), t) != nullptr)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+    inserisciCoppia(new Couple<K,E>(std::move(couple)));
+}
+/**
+ * @brief Metodo che rimuove la coppia con chiave key dal dizionario.
+ * La coppia viene liberata solo quando nessun lettore può più raggiungerla.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ */
+template<class K, class E, class H>
+void LockFreeHash<K,E,H>::cancella(const Key& key) {
+    std::lock_guard<std::mutex> guardia(scrittura);
+    passoTrasferimento();
+    Tabella* t;
+    std::atomic<Couple<K,E>*>* s = cercaSlot(key, t);
+    if (s == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    Couple<K,E>* c = s->load(std::memory_order_relaxed);
+    s->store(cancellato(), std::memory_order_release);
+    t->usati--;
+    t->cancellati++;
+    numElementi.fetch_sub(1, std::memory_order_relaxed);
+    ritira(c);
+}
+/**
+ * @brief Metodo che restituisce una copia dell'elemento associato alla chiave key.
+ * Non acquisisce lock.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @return elemento associato alla chiave key.
+ */
+template<class K, class E, class H>
+typename LockFreeHash<K,E,H>::Element LockFreeHash<K,E,H>::recupera(const Key& key) const {
+    SezioneLettura sezione(*this);
+    const Couple<K,E>* c = cerca(key);
+    if (c == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    return c->getElement();
+}
+/**
+ * @brief Metodo che verifica se il dizionario contiene una coppia con chiave key.
+ * Non acquisisce lock.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @return true se il dizionario contiene una coppia con chiave key, false altrimenti.
+ */
+template<class K, class E, class H>
+bool LockFreeHash<K,E,H>::appartiene(const Key& key) const {
+    SezioneLettura sezione(*this);
+    return cerca(key) != nullptr;
+}
+/**
+ * @brief Metodo che aggiorna il valore associato a una chiave esistente.
+ * La coppia viene sostituita da una nuova: i lettori vedono l'elemento precedente
+ * oppure quello nuovo, mai uno parzialmente modificato.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param element nuovo elemento.
+ */
+template<class K, class E, class H>
+void LockFreeHash<K,E,H>::aggiorna(const Key& key, const Element& element) {
+    std::lock_guard<std::mutex> guardia(scrittura);
+    passoTrasferimento();
+    Tabella* t;
+    std::atomic<Couple<K,E>*>* s = cercaSlot(key, t);
+    if (s == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    Couple<K,E>* c = s->load(std::memory_order_relaxed);
+    s->store(new Couple<K,E>(c->getKey(), element), std::memory_order_release);
+    ritira(c);
+}
+/**
+ * @brief Metodo che copia l'elemento associato a key senza sollevare eccezioni.
+ * Non acquisisce lock.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param element parametro di uscita in cui copiare l'elemento trovato.
+ * @return true se la chiave è presente, false altrimenti (element non viene modificato).
+ */
+template<class K, class E, class H>
+bool LockFreeHash<K,E,H>::tryGet(const Key& key, Element& element) const {
+    SezioneLettura sezione(*this);
+    const Couple<K,E>* c = cerca(key);
+    if (c == nullptr)
+        return false;
+    element = c->getElement();
+    return true;
+}
+/**
+ * @brief Metodo che inserisce la coppia < key, element > oppure, se la chiave è già
+ * presente, la sostituisce con una nuova coppia con elemento element.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param element elemento da inserire o assegnare.
+ * @return true se la coppia è stata inserita, false se è stata aggiornata.
+ */
+template<class K, class E, class H>
+template<class E1>
+bool LockFreeHash<K,E,H>::insert_or_assign(const Key& key, E1&& element) {
+    std::lock_guard<std::mutex> guardia(scrittura);
+    passoTrasferimento();
+    Couple<K,E>* nuova = new Couple<K,E>(std::piecewise_construct, key, std::forward<E1>(element));
+    Tabella* t;
+    std::atomic<Couple<K,E>*>* s = cercaSlot(key, t);
+    if (s == nullptr) {
+        inserisciCoppia(nuova);
+        return true;
+    }
+    Couple<K,E>* c = s->load(std::memory_order_relaxed);
+    s->store(nuova, std::memory_order_release);
+    ritira(c);
+    return false;
+}
+/**
+ * @brief Metodo che svuota il dizionario sostituendo la tabella con una vuota.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+void LockFreeHash<K,E,H>::clear() {
+    std::lock_guard<std::mutex> guardia(scrittura);
+    Tabella* vecchia = corrente.load(std::memory_order_relaxed);
+    corrente.store(new Tabella(8), std::memory_order_release);
+    trasferiti = 0;
+    numElementi.store(0, std::memory_order_relaxed);
+    // Nessun nuovo lettore raggiunge le vecchie tabelle: dopo la sincronizzazione
+    // possono essere liberate insieme alle coppie che contengono
+    sincronizza();
+    liberaTabella(vecchia);
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutte le chiavi del dizionario.
+ * Acquisisce il lock degli scrittori, così che il risultato corrisponda a un unico istante.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutte le chiavi del dizionario.
+ */
+template<class K, class E, class H>
+VectorList<K> LockFreeHash<K,E,H>::keys() const {
+    std::lock_guard<std::mutex> guardia(scrittura);
+    VectorList<K> keys;
+    for (Tabella* t = corrente.load(std::memory_order_relaxed); t != nullptr; t = t->nuova.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < t->dim; i++) {
+            Couple<K,E>* c = t->slot[i].load(std::memory_order_relaxed);
+            if (valida(c))
+                keys.inserisciCoda(c->getKey());
+        }
+    }
+    return keys;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutti gli elementi del dizionario.
+ * Acquisisce il lock degli scrittori, così che il risultato corrisponda a un unico istante.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutti gli elementi del dizionario.
+ */
+template<class K, class E, class H>
+VectorList<E> LockFreeHash<K,E,H>::values() const {
+    std::lock_guard<std::mutex> guardia(scrittura);
+    VectorList<E> values;
+    for (Tabella* t = corrente.load(std::memory_order_relaxed); t != nullptr; t = t->nuova.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < t->dim; i++) {
+            Couple<K,E>* c = t->slot[i].load(std::memory_order_relaxed);
+            if (valida(c))
+                values.inserisciCoda(c->getElement());
+        }
+    }
+    return values;
+}
+/**
+ * @brief Costruttore di una tabella di dim bucket vuoti.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param dim numero di bucket, potenza di 2.
+ */
+template<class K, class E, class H>
+LockFreeHash<K,E,H>::Tabella::Tabella(int dim) : dim(dim), nuova(nullptr), usati(0), cancellati(0) {
+    slot = new std::atomic<Couple<K,E>*>[dim];
+    for (int i = 0; i < dim; i++)
+        slot[i].store(nullptr, std::memory_order_relaxed);
+    bitIndice = 0;
+    while ((1 << bitIndice) < dim)
+        bitIndice++;
+}
+/**
+ * @brief Distruttore della tabella: non libera le coppie, che possono essere condivise
+ * con la tabella successiva durante un trasferimento.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+LockFreeHash<K,E,H>::Tabella::~Tabella() {
+    delete[] slot;
+}
+/**
+ * @brief Costruttore della sezione di lettura.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param h dizionario da leggere.
+ */
+template<class K, class E, class H>
+LockFreeHash<K,E,H>::SezioneLettura::SezioneLettura(const LockFreeHash& h) : contatore(entra(h)) {}
+/**
+ * @brief Distruttore della sezione di lettura: il lettore esce dalla propria epoca.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+LockFreeHash<K,E,H>::SezioneLettura::~SezioneLettura() {
+    contatore.fetch_sub(1, std::memory_order_release);
+}
+/**
+ * @brief Metodo che registra il lettore nell'epoca corrente.
+ * Se l'epoca avanza tra la lettura e la registrazione, la registrazione viene ripetuta:
+ * uno scrittore che attende i lettori dell'epoca precedente non può quindi ignorare
+ * un lettore che ha letto quell'epoca.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param h dizionario da leggere.
+ * @return contatore incrementato, da decrementare all'uscita.
+ */
+template<class K, class E, class H>
+std::atomic<int>& LockFreeHash<K,E,H>::SezioneLettura::entra(const LockFreeHash& h) {
+    Striscia& s = h.strisce[striscia()];
+    for (;;) {
+        uint64_t e = h.epoca.load();
+        std::atomic<int>& c = s.attivi[e & 1];
+        c.fetch_add(1);
+        if (h.epoca.load() == e)
+            return c;
+        c.fetch_sub(1);
+    }
+}
+/**
+ * @brief Metodo che restituisce la striscia di contatori del thread chiamante.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return indice della striscia, calcolato una sola volta per thread.
+ */
+template<class K, class E, class H>
+int LockFreeHash<K,E,H>::striscia() {
+    static thread_local int s = static_cast<int>(
+            HashBase::mescola(std::hash<std::thread::id>()(std::this_thread::get_id())) & (STRISCE - 1));
+    return s;
+}
+/**
+ * @brief Metodo che calcola il bucket ideale di un hash in una tabella (hashing di Fibonacci).
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param h hash della chiave.
+ * @param t tabella.
+ * @return indice del bucket ideale.
+ */
+template<class K, class E, class H>
+int LockFreeHash<K,E,H>::calcHome(size_t h, const Tabella* t) const {
+    return static_cast<int>((uint64_t(h) * 0x9E3779B97F4A7C15ULL) >> (64 - t->bitIndice));
+}
+/**
+ * @brief Metodo che cerca la coppia con chiave key senza acquisire lock.
+ * Percorre la sequenza di sondaggio della tabella corrente fino al primo bucket vuoto,
+ * saltando bucket cancellati e spostati, e prosegue nella tabella nuova se è in
+ * corso un trasferimento. Durante un trasferimento nessun bucket vuoto della tabella
+ * corrente viene più occupato, quindi una chiave non trovata in essa si trova, se
+ * presente, nella tabella nuova.
+ * Deve essere chiamato all'interno di una sezione di lettura o con il lock degli scrittori.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia, nullptr se la chiave non è presente.
+ */
+template<class K, class E, class H>
+Couple<K,E>* LockFreeHash<K,E,H>::cerca(const Key& key) const {
+    size_t h = hash(key);
+    for (Tabella* t = corrente.load(std::memory_order_acquire); t != nullptr; t = t->nuova.load(std::memory_order_acquire)) {
+        int j = calcHome(h, t);
+        for (int n = 0; n < t->dim; n++) {
+            Couple<K,E>* c = t->slot[j].load(std::memory_order_acquire);
+            if (c == nullptr)
+                break;
+            if (valida(c) && c->getKey() == key)
+                return c;
+            j = (j + 1) & (t->dim - 1);
+        }
+    }
+    return nullptr;
+}
+/**
+ * @brief Metodo che individua il bucket contenente la chiave key. Solo per gli scrittori.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param t parametro di uscita: tabella che contiene il bucket.
+ * @return bucket contenente la chiave, nullptr se la chiave non è presente.
+ */
+template<class K, class E, class H>
+std::atomic<Couple<K,E>*>* LockFreeHash<K,E,H>::cercaSlot(const Key& key, Tabella*& t) const {
+    size_t h = hash(key);
+    for (t = corrente.load(std::memory_order_relaxed); t != nullptr; t = t->nuova.load(std::memory_order_relaxed)) {
+        int j = calcHome(h, t);
+        for (int n = 0; n < t->dim; n++) {
+            Couple<K,E>* c = t->slot[j].load(std::memory_order_relaxed);
+            if (c == nullptr)
+                break;
+            if (valida(c) && c->getKey() == key)
+                return &t->slot[j];
+            j = (j + 1) & (t->dim - 1);
+        }
+    }
+    return nullptr;
+}
+/**
+ * @brief Metodo che pubblica una coppia nel primo bucket vuoto o cancellato della sua
+ * sequenza di sondaggio nella tabella t. Solo per gli scrittori.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param t tabella di destinazione, con almeno un bucket vuoto.
+ * @param c coppia da pubblicare, non presente nel dizionario.
+ */
+template<class K, class E, class H>
+void LockFreeHash<K,E,H>::inserisciNodo(Tabella* t, Couple<K,E>* c) {
+    int j = calcHome(hash(c->getKey()), t);
+    for (;;) {
+        Couple<K,E>* s = t->slot[j].load(std::memory_order_relaxed);
+        if (s == nullptr || s == cancellato()) {
+            if (s == cancellato())
+                t->cancellati--;
+            t->slot[j].store(c, std::memory_order_release);
+            t->usati++;
+            return;
+        }
+        j = (j + 1) & (t->dim - 1);
+    }
+}
+/**
+ * @brief Metodo che inserisce una nuova coppia, avviando un ridimensionamento quando
+ * i bucket occupati o cancellati raggiungono metà della tabella. Solo per gli scrittori.
+ * Con molti bucket cancellati la nuova tabella ha la stessa dimensione, altrimenti
+ * dimensione doppia.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia da inserire, non presente nel dizionario.
+ */
+template<class K, class E, class H>
+void LockFreeHash<K,E,H>::inserisciCoppia(Couple<K,E>* c) {
+    Tabella* t = corrente.load(std::memory_order_relaxed);
+    Tabella* n = t->nuova.load(std::memory_order_relaxed);
+    if (n == nullptr && (t->usati + t->cancellati + 1) * 2 > t->dim) {
+        n = new Tabella(t->usati * 4 > t->dim ? t->dim * 2 : t->dim);
+        trasferiti = 0;
+        t->nuova.store(n, std::memory_order_release);
+    }
+    inserisciNodo(n != nullptr ? n : t, c);
+    numElementi.fetch_add(1, std::memory_order_relaxed);
+}
+/**
+ * @brief Metodo che trasferisce al più PASSO bucket della tabella corrente nella tabella
+ * nuova. Ogni coppia viene prima pubblicata nella tabella nuova e poi il bucket di
+ * origine viene marcato come spostato, così che un lettore la trovi sempre in almeno
+ * una delle due. Al termine la tabella nuova diventa quella corrente. Solo per gli scrittori.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+void LockFreeHash<K,E,H>::passoTrasferimento() {
+    Tabella* t = corrente.load(std::memory_order_relaxed);
+    Tabella* n = t->nuova.load(std::memory_order_relaxed);
+    if (n == nullptr)
+        return;
+
+    int fine = trasferiti + PASSO < t->dim ? trasferiti + PASSO : t->dim;
+    for (; trasferiti < fine; trasferiti++) {
+        Couple<K,E>* c = t->slot[trasferiti].load(std::memory_order_relaxed);
+        if (valida(c)) {
+            inserisciNodo(n, c);
+            t->slot[trasferiti].store(spostato(), std::memory_order_release);
+        } else if (c == cancellato()) {
+            t->slot[trasferiti].store(spostato(), std::memory_order_release);
+        }
+    }
+
+    if (trasferiti == t->dim) {
+        corrente.store(n, std::memory_order_release);
+        trasferiti = 0;
+        tabelleRitirate.push_back(t);
+        sincronizza();
+    }
+}
+/**
+ * @brief Metodo che registra una coppia rimossa, da liberare quando nessun lettore
+ * può più raggiungerla. Solo per gli scrittori.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia rimossa.
+ */
+template<class K, class E, class H>
+void LockFreeHash<K,E,H>::ritira(Couple<K,E>* c) {
+    coppieRitirate.push_back(c);
+    if ((int)coppieRitirate.size() >= RITIRATI_MAX)
+        sincronizza();
+}
+/**
+ * @brief Metodo che fa avanzare l'epoca, attende l'uscita dei lettori entrati
+ * nell'epoca precedente e libera coppie e tabelle ritirate. Solo per gli scrittori.
+ * Ogni avanzamento attende i lettori dell'epoca che si chiude, quindi dopo di esso
+ * nessun lettore può trovarsi in un'epoca precedente a quella corrente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+void LockFreeHash<K,E,H>::sincronizza() {
+    uint64_t e = epoca.load();
+    epoca.store(e + 1);
+    for (int i = 0; i < STRISCE; i++) {
+        while (strisce[i].attivi[e & 1].load() != 0)
+            std::this_thread::yield();
+    }
+    for (Couple<K,E>* c : coppieRitirate)
+        delete c;
+    coppieRitirate.clear();
+    for (Tabella* t : tabelleRitirate)
+        delete t;
+    tabelleRitirate.clear();
+}
+/**
+ * @brief Metodo che libera una tabella, le tabelle a essa collegate e le coppie che
+ * contengono. Le coppie condivise tra due tabelle sono marcate come spostate in una
+ * delle due e vengono quindi liberate una sola volta.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param t tabella da liberare.
+ */
+template<class K, class E, class H>
+void LockFreeHash<K,E,H>::liberaTabella(Tabella* t) {
+    while (t != nullptr) {
+        for (int i = 0; i < t->dim; i++) {
+            Couple<K,E>* c = t->slot[i].load(std::memory_order_relaxed);
+            if (valida(c))
+                delete c;
+        }
+        Tabella* n = t->nuova.load(std::memory_order_relaxed);
+        delete t;
+        t = n;
+    }
+}
+
+#endif //DICTIONARY_LOCKFREEHASH_H
@@ -0,0 +1,409 @@
+#ifndef DICTIONARY_MAPPEDHASH_H
+#define DICTIONARY_MAPPEDHASH_H
+
+#include "Dictionary.h"
+#include "Hash.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Descrive come un tipo viene memorizzato in uno snapshot di MappedHash.
+ * Un tipo banalmente copiabile occupa un campo di dimensione fissa, arrotondata a
+ * un multiplo di 8 byte, che contiene direttamente la sua rappresentazione in memoria
+ * e viene letto per copia. Le chiavi non devono avere byte di padding, perché l'hash
+ * e i confronti sono calcolati sui byte.
+ * @tparam T tipo della chiave o dell'elemento.
+ */
+template <class T>
+struct FormatoSnapshot {
+    static_assert(std::is_trivially_copyable<T>::value, "Il tipo deve essere banalmente copiabile o string.");
+
+    typedef T Vista;    // tipo restituito dalle letture sullo snapshot
+    static const uint32_t TIPO = 0;
+    static const uint32_t CAMPO = (sizeof(T) + 7) / 8 * 8;
+
+    static std::string_view bytes(const T& v) {
+        return std::string_view(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+    static size_t dati(const T&) {return 0;}
+    static void scrivi(unsigned char* campo, const T& v, uint64_t) {std::memcpy(campo, &v, sizeof(T));}
+    static Vista leggi(const char*, size_t, const unsigned char* campo) {
+        T v;
+        std::memcpy(&v, campo, sizeof(T));
+        return v;
+    }
+};
+/**
+ * @brief Specializzazione di FormatoSnapshot per il tipo string.
+ * Il campo contiene offset e lunghezza dei caratteri, memorizzati nell'area dati
+ * dello snapshot; l'offset è relativo all'inizio del file. La lettura controlla che
+ * i caratteri siano contenuti nel file, così che uno snapshot danneggiato non
+ * provochi letture fuori dalla mappatura.
+ */
+template <>
+struct FormatoSnapshot<string> {
+    typedef std::string_view Vista;
+    static const uint32_t TIPO = 1;
+    static const uint32_t CAMPO = 16;
+
+    static std::string_view bytes(std::string_view v) {return v;}
+    static size_t dati(const string& v) {return v.size();}
+    static void scrivi(unsigned char* campo, const string& v, uint64_t offset) {
+        uint64_t lunghezza = v.size();
+        std::memcpy(campo, &offset, 8);
+        std::memcpy(campo + 8, &lunghezza, 8);
+    }
+    static Vista leggi(const char* base, size_t dimensione, const unsigned char* campo) {
+        uint64_t offset, lunghezza;
+        std::memcpy(&offset, campo, 8);
+        std::memcpy(&lunghezza, campo + 8, 8);
+        if (offset > dimensione || lunghezza > dimensione - offset)
+            throw std::runtime_error("Error: lo snapshot e' danneggiato.");
+        return std::string_view(base + offset, lunghezza);
+    }
+};
+
+/**
+ * @brief Classe che rappresenta un dizionario in sola lettura mappato in memoria da
+ * uno snapshot su file.
+ * Lo snapshot viene prodotto da scrivi() a partire da un dizionario in memoria ed è
+ * una tabella hash chiusa già costruita: aprirlo richiede solo mmap() e la verifica
+ * dell'intestazione, senza alcuna lettura o decodifica delle coppie, che vengono
+ * caricate dal sistema operativo al primo accesso.
+ * <br>
+ * Il file è composto da:
+ * <ul>
+ * <li> un'intestazione con numero magico, versione, numero di coppie e di bucket,
+ * formato di chiavi ed elementi e offset delle sezioni; </li>
+ * <li> un byte di controllo per bucket: 0 se vuoto, altrimenti 0x80 più i 7 bit
+ * bassi dell'hash della chiave, così che quasi tutti i confronti falliti si
+ * risolvano senza leggere la chiave; </li>
+ * <li> i bucket, ognuno con il campo della chiave seguito da quello dell'elemento
+ * (vedi FormatoSnapshot); </li>
+ * <li> l'area dati con i caratteri delle stringhe. </li>
+ * </ul>
+ * Tutti i riferimenti sono offset dall'inizio del file, quindi il file non dipende
+ * dall'indirizzo a cui viene mappato. L'hash è HashBase::hashBytes sui byte della
+ * chiave con seme 0, indipendente dalla funzione hash del dizionario di origine e
+ * dal processo. I valori sono memorizzati nell'ordine dei byte della macchina:
+ * uno snapshot scritto su un'architettura con ordine diverso viene rifiutato.
+ * <br>
+ * Le letture di stringhe restituiscono string_view all'interno della mappatura,
+ * valide finché l'oggetto MappedHash esiste.
+ * @tparam K tipo della chiave, banalmente copiabile o string.
+ * @tparam E tipo dell'elemento, banalmente copiabile o string.
+ */
+template <class K, class E>
+class MappedHash {
+public:
+    typedef typename FormatoSnapshot<K>::Vista VistaChiave;
+    typedef typename FormatoSnapshot<E>::Vista VistaElemento;
+
+    explicit MappedHash(const std::string&);
+    MappedHash(const MappedHash&) = delete;
+    MappedHash& operator=(const MappedHash&) = delete;
+    ~MappedHash();
+
+    bool dizionarioVuoto() const {return numeroCoppie == 0;}
+    int lunghezza() const {return static_cast<int>(numeroCoppie);}
+    bool appartiene(VistaChiave) const;
+    VistaElemento recupera(VistaChiave) const;
+    bool tryGet(VistaChiave, VistaElemento&) const;
+
+    template<class D>
+    static void scrivi(const D&, const std::string&);
+
+private:
+    /**
+     * @brief Intestazione dello snapshot, all'offset 0 del file.
+     */
+    struct Intestazione {
+        char magia[8];
+        uint32_t ordineByte;
+        uint32_t versione;
+        uint64_t numeroCoppie;
+        uint64_t numeroBucket;
+        uint32_t tipoChiave;
+        uint32_t campoChiave;
+        uint32_t tipoElemento;
+        uint32_t campoElemento;
+        uint64_t offsetControllo;
+        uint64_t offsetBucket;
+        uint64_t offsetDati;
+        uint64_t dimensioneFile;
+    };
+
+    static constexpr char MAGIA[8] = {'D', 'S', 'N', 'A', 'P', 'H', 'T', '1'};
+    static const uint32_t ORDINE_BYTE = 0x01020304;
+    static const uint32_t VERSIONE = 1;
+    static const uint32_t DIM_BUCKET = FormatoSnapshot<K>::CAMPO + FormatoSnapshot<E>::CAMPO;
+
+    static uint64_t calcHash(VistaChiave);
+    static uint64_t allinea(uint64_t n) {return (n + 7) / 8 * 8;}
+    int64_t cercaSlot(VistaChiave) const;
+    void verifica(const std::string&) const;
+
+    char* base;                     // inizio della mappatura
+    size_t dimensione;              // byte mappati
+    const unsigned char* controllo;
+    const unsigned char* bucket;
+    uint64_t numeroCoppie;
+    uint64_t maschera;              // numeroBucket - 1
+    int bitIndice;                  // log2(numeroBucket)
+};
+/**
+ * @brief Costruttore che mappa in memoria, in sola lettura, lo snapshot nel file percorso.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param percorso percorso del file.
+ */
+template <class K, class E>
+MappedHash<K,E>::MappedHash(const std::string& percorso) {
+    int fd = ::open(percorso.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Error: impossibile aprire lo snapshot " + percorso);
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(Intestazione)) {
+        ::close(fd);
+        throw std::runtime_error("Error: lo snapshot " + percorso + " non e' valido.");
+    }
+    dimensione = static_cast<size_t>(info.st_size);
+    void* p = ::mmap(nullptr, dimensione, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);    // la mappatura resta valida anche dopo la chiusura del file
+    if (p == MAP_FAILED)
+        throw std::runtime_error("Error: impossibile mappare lo snapshot " + percorso);
+    base = static_cast<char*>(p);
+
+    try {
+        verifica(percorso);
+    } catch (...) {
+        ::munmap(base, dimensione);
+        throw;
+    }
+    const Intestazione* h = reinterpret_cast<const Intestazione*>(base);
+    controllo = reinterpret_cast<const unsigned char*>(base + h->offsetControllo);
+    bucket = reinterpret_cast<const unsigned char*>(base + h->offsetBucket);
+    numeroCoppie = h->numeroCoppie;
+    maschera = h->numeroBucket - 1;
+    bitIndice = 0;
+    while ((uint64_t(1) << bitIndice) < h->numeroBucket)
+        bitIndice++;
+}
+/**
+ * @brief Distruttore: rilascia la mappatura.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E>
+MappedHash<K,E>::~MappedHash() {
+    ::munmap(base, dimensione);
+}
+/**
+ * @brief Metodo che controlla che l'intestazione descriva uno snapshot leggibile
+ * con i tipi K ed E e che tutte le sezioni siano contenute nel file. Il contenuto
+ * dei bucket non viene esaminato: aprire lo snapshot non dipende dal numero di coppie.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param percorso percorso del file, per il messaggio d'errore.
+ */
+template <class K, class E>
+void MappedHash<K,E>::verifica(const std::string& percorso) const {
+    const Intestazione* h = reinterpret_cast<const Intestazione*>(base);
+    uint64_t n = h->numeroBucket;
+    if (std::memcmp(h->magia, MAGIA, sizeof(MAGIA)) != 0 || h->versione != VERSIONE)
+        throw std::runtime_error("Error: " + percorso + " non e' uno snapshot di MappedHash.");
+    if (h->ordineByte != ORDINE_BYTE)
+        throw std::runtime_error("Error: lo snapshot " + percorso + " usa un ordine dei byte diverso.");
+    if (h->tipoChiave != FormatoSnapshot<K>::TIPO || h->campoChiave != FormatoSnapshot<K>::CAMPO
+        || h->tipoElemento != FormatoSnapshot<E>::TIPO || h->campoElemento != FormatoSnapshot<E>::CAMPO)
+        throw std::runtime_error("Error: lo snapshot " + percorso + " contiene tipi diversi da quelli richiesti.");
+    // Ogni bucket occupa almeno DIM_BUCKET byte del file: limitare n a dimensione / DIM_BUCKET
+    // e gli offset a dimensione esclude gli overflow nelle somme e nei prodotti seguenti
+    if (n < 8 || (n & (n - 1)) != 0 || n > dimensione / DIM_BUCKET || h->numeroCoppie >= n
+        || h->dimensioneFile != dimensione || h->offsetControllo > dimensione || h->offsetBucket > dimensione
+        || h->offsetDati > dimensione || h->offsetControllo + n > h->offsetBucket || h->offsetBucket % 8 != 0
+        || h->offsetBucket + n * DIM_BUCKET > h->offsetDati)
+        throw std::runtime_error("Error: lo snapshot " + percorso + " e' danneggiato.");
+}
+/**
+ * @brief Metodo che calcola l'hash di una chiave, indipendente dal processo.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @return hash della chiave.
+ */
+template <class K, class E>
+uint64_t MappedHash<K,E>::calcHash(VistaChiave key) {
+    std::string_view b = FormatoSnapshot<K>::bytes(key);
+    return HashBase::hashBytes(b.data(), b.size(), 0);
+}
+/**
+ * @brief Metodo che individua il bucket contenente la chiave key.
+ * Il bucket ideale è dato dai bit alti dell'hash, il byte di controllo dai 7 bit bassi.
+ * La scansione esamina al più tutti i bucket, anche se uno snapshot danneggiato non
+ * ne contiene di vuoti.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return indice del bucket contenente key, -1 se la chiave non è presente.
+ */
+template <class K, class E>
+int64_t MappedHash<K,E>::cercaSlot(VistaChiave key) const {
+    uint64_t h = calcHash(key);
+    unsigned char firma = 0x80 | (h & 0x7F);
+    std::string_view cercata = FormatoSnapshot<K>::bytes(key);
+    uint64_t j = h >> (64 - bitIndice);
+    for (uint64_t passi = 0; passi <= maschera && controllo[j] != 0; passi++, j = (j + 1) & maschera) {
+        if (controllo[j] == firma) {
+            VistaChiave k = FormatoSnapshot<K>::leggi(base, dimensione, bucket + j * DIM_BUCKET);
+            if (FormatoSnapshot<K>::bytes(k) == cercata)
+                return static_cast<int64_t>(j);
+        }
+    }
+    return -1;
+}
+/**
+ * @brief Metodo che controlla se la chiave key è presente nello snapshot.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return true se la chiave è presente, false altrimenti.
+ */
+template <class K, class E>
+bool MappedHash<K,E>::appartiene(VistaChiave key) const {
+    return cercaSlot(key) != -1;
+}
+/**
+ * @brief Metodo che recupera l'elemento associato alla chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return l'elemento, oppure una string_view sui suoi caratteri all'interno della mappatura.
+ */
+template <class K, class E>
+typename MappedHash<K,E>::VistaElemento MappedHash<K,E>::recupera(VistaChiave key) const {
+    int64_t i = cercaSlot(key);
+    if (i == -1)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    return FormatoSnapshot<E>::leggi(base, dimensione, bucket + i * DIM_BUCKET + FormatoSnapshot<K>::CAMPO);
+}
+/**
+ * @brief Metodo che recupera l'elemento associato a key senza sollevare eccezioni
+ * se la chiave è assente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param element riceve la vista sull'elemento, se la chiave è presente.
+ * @return true se la chiave è presente, false altrimenti.
+ */
+template <class K, class E>
+bool MappedHash<K,E>::tryGet(VistaChiave key, VistaElemento& element) const {
+    int64_t i = cercaSlot(key);
+    if (i == -1)
+        return false;
+    element = FormatoSnapshot<E>::leggi(base, dimensione, bucket + i * DIM_BUCKET + FormatoSnapshot<K>::CAMPO);
+    return true;
+}
+/**
+ * @brief Metodo che scrive nel file percorso lo snapshot del dizionario d.
+ * Il file viene prima scritto con un nome temporaneo e poi rinominato, così che
+ * un lettore non possa mai mappare uno snapshot incompleto.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam D dizionario iterabile con lunghezza(), per esempio ClosedHash<K, E>.
+ * @param d dizionario da salvare.
+ * @param percorso percorso del file.
+ */
+template <class K, class E>
+template <class D>
+void MappedHash<K,E>::scrivi(const D& d, const std::string& percorso) {
+    uint64_t n = d.lunghezza();
+    uint64_t dim = 8;
+    int bit = 3;
+    while (n >= dim * 3 / 4) {
+        dim *= 2;
+        bit++;
+    }
+
+    // Costruisce la tabella in memoria: per ogni bucket un puntatore alla coppia nel dizionario
+    std::vector<unsigned char> controllo(dim, 0);
+    std::vector<const Couple<K,E>*> coppie(dim, nullptr);
+    uint64_t dati = 0;
+    for (const Couple<K,E>& c : d) {
+        uint64_t h = calcHash(c.getKey());
+        uint64_t j = h >> (64 - bit);
+        while (controllo[j] != 0)
+            j = (j + 1) & (dim - 1);
+        controllo[j] = 0x80 | (h & 0x7F);
+        coppie[j] = &c;
+        dati += FormatoSnapshot<K>::dati(c.getKey()) + FormatoSnapshot<E>::dati(c.getElement());
+    }
+
+    Intestazione h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magia, MAGIA, sizeof(MAGIA));
+    h.ordineByte = ORDINE_BYTE;
+    h.versione = VERSIONE;
+    h.numeroCoppie = n;
+    h.numeroBucket = dim;
+    h.tipoChiave = FormatoSnapshot<K>::TIPO;
+    h.campoChiave = FormatoSnapshot<K>::CAMPO;
+    h.tipoElemento = FormatoSnapshot<E>::TIPO;
+    h.campoElemento = FormatoSnapshot<E>::CAMPO;
+    h.offsetControllo = allinea(sizeof(Intestazione));
+    h.offsetBucket = allinea(h.offsetControllo + dim);
+    h.offsetDati = h.offsetBucket + dim * DIM_BUCKET;
+    h.dimensioneFile = h.offsetDati + dati;
+
+    std::string temporaneo = percorso + ".tmp";
+    std::ofstream out(temporaneo, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("Error: impossibile creare lo snapshot " + temporaneo);
+    const char zeri[8] = {};
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(zeri, h.offsetControllo - sizeof(h));
+    out.write(reinterpret_cast<const char*>(controllo.data()), dim);
+    out.write(zeri, h.offsetBucket - h.offsetControllo - dim);
+
+    // Bucket, con gli offset delle stringhe assegnati nell'ordine in cui vengono scritte
+    std::vector<unsigned char> record(DIM_BUCKET);
+    uint64_t offset = h.offsetDati;
+    for (uint64_t j = 0; j < dim; j++) {
+        std::fill(record.begin(), record.end(), 0);
+        if (coppie[j] != nullptr) {
+            FormatoSnapshot<K>::scrivi(record.data(), coppie[j]->getKey(), offset);
+            offset += FormatoSnapshot<K>::dati(coppie[j]->getKey());
+            FormatoSnapshot<E>::scrivi(record.data() + FormatoSnapshot<K>::CAMPO, coppie[j]->getElement(), offset);
+            offset += FormatoSnapshot<E>::dati(coppie[j]->getElement());
+        }
+        out.write(reinterpret_cast<const char*>(record.data()), DIM_BUCKET);
+    }
+    for (uint64_t j = 0; j < dim; j++) {
+        if (coppie[j] == nullptr)
+            continue;
+        if (FormatoSnapshot<K>::TIPO == 1)
+            out.write(FormatoSnapshot<K>::bytes(coppie[j]->getKey()).data(), FormatoSnapshot<K>::dati(coppie[j]->getKey()));
+        if (FormatoSnapshot<E>::TIPO == 1)
+            out.write(FormatoSnapshot<E>::bytes(coppie[j]->getElement()).data(), FormatoSnapshot<E>::dati(coppie[j]->getElement()));
+    }
+
+    out.close();
+    if (!out || std::rename(temporaneo.c_str(), percorso.c_str()) != 0) {
+        std::remove(temporaneo.c_str());
+        throw std::runtime_error("Error: impossibile scrivere lo snapshot " + percorso);
+    }
+}
+
+#endif //DICTIONARY_MAPPEDHASH_H
@@ -4,116 +4,690 @@
 #include "Dictionary.h"
 #include "Hash.h"
 #include "../List/VectorList.h"
+#include <cstddef>
+#include <iterator>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+template <class K, class E, class H = Hash<K>>
+class OpenHash;
+
+/**
+ * @brief Classe che rappresenta un nodo di una catena di OpenHash.
+ * Contiene una coppia < K, E > e l'indice del nodo successivo nella stessa catena.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E>
+class NodoCatena {
+    template <class K1, class E1, class H1>
+    friend class OpenHash;
+
+public:
+    template <class... Args>
+    NodoCatena(int s, Args&&... args) : coppia(std::forward<Args>(args)...), successivo(s) {}
+
+private:
+    Couple<K,E> coppia;
+    int successivo;         // indice del nodo successivo nella catena, -1 se ultimo
+};
 
 /**
  * @brief Classe che rappresenta un dizionario implementato con hash aperto.
- * La struttura è composta da un certo numero (maxBuckets) di contenitori di uguale
- * dimensione denominati bucket. Ognuno di questi contenitori può mantenere al
- * proprio interno al massimo una coppia < K, E >.
+ * La struttura è composta da un certo numero (divisore) di bucket, ognuno dei quali
+ * è la testa di una catena contenente tutte le coppie < K, E > la cui chiave viene
+ * associata a quel bucket dalla funzione hash.
+ * <br>
+ * I nodi di tutte le catene sono memorizzati in un unico array contiguo (pool) e
+ * sono collegati tramite indici: un bucket vuoto occupa solo un intero. Il pool
+ * è mantenuto compatto, spostando l'ultimo nodo al posto di quello cancellato.
+ * Quando il numero di coppie supera il numero di bucket (fattore di carico 1)
+ * il numero di bucket viene raddoppiato e le catene vengono ricollegate senza
+ * copiare le coppie: inserimento, ricerca e cancellazione costano O(1) attesi.
  * <br>
- * Si utilizza un funzione aritmetica allo scopo di calcolare, partendo
- * dalla chiave, la posizione in tabella delle informazioni contenute nella coppia.
+ * Le coppie si possono visitare senza copiarle con un ciclo for sul dizionario o su
+ * entries(), che scorrono il pool nell'ordine in cui è memorizzato: ogni operazione
+ * di modifica invalida gli iteratori.
  * @tparam K tipo della chiave.
  * @tparam E tipo dell'elemento.
+ * @tparam H funzione hash, per default Hash<K>.
  */
-template <class K, class E>
+template <class K, class E, class H>
 class OpenHash : public Dictionary<K,E> {
 public:
     typedef typename Dictionary<K,E>::Key Key;
     typedef typename Dictionary<K,E>::Element Element;
 
+    /**
+     * @brief Iteratore in avanti sulle coppie del dizionario.
+     * @tparam Costante true per un iteratore che non consente di modificare le coppie.
+     */
+    template <bool Costante>
+    class Iteratore {
+        typedef typename std::conditional<Costante, const NodoCatena<K,E>, NodoCatena<K,E>>::type Nodo;
+        typedef typename std::conditional<Costante, const Couple<K,E>, Couple<K,E>>::type Voce;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Couple<K,E> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Voce* pointer;
+        typedef Voce& reference;
+
+        Iteratore() : nodo(nullptr) {}
+        Iteratore(const Iteratore<false>& it) : nodo(it.nodo) {}
+
+        reference operator*() const {return nodo->coppia;}
+        pointer operator->() const {return &nodo->coppia;}
+        Iteratore& operator++() {
+            nodo++;
+            return *this;
+        }
+        Iteratore operator++(int) {
+            Iteratore it = *this;
+            nodo++;
+            return it;
+        }
+        bool operator==(const Iteratore& it) const {return nodo == it.nodo;}
+        bool operator!=(const Iteratore& it) const {return nodo != it.nodo;}
+
+    private:
+        friend class OpenHash;
+        template <bool> friend class Iteratore;
+        explicit Iteratore(Nodo* nodo) : nodo(nodo) {}
+
+        Nodo* nodo;     // nodo corrente del pool
+    };
+    typedef Iteratore<false> iterator;
+    typedef Iteratore<true> const_iterator;
+
     OpenHash();
     OpenHash(int);
     OpenHash(const OpenHash&);
     ~OpenHash();
 
-    bool isEmpty() const;
-    void insert(Couple<Key,Element>&);
-    void remove(const Key&);
-    Element get(const Key&) const;
-    bool containsKey(const Key&) const;
-    void update(const Key&, const Element&);
+    bool dizionarioVuoto() const;
+    void inserisci(const Couple<Key,Element>&);
+    void inserisci(Couple<Key,Element>&&);
+    void cancella(const Key&);
+    Element recupera(const Key&) const;
+    bool appartiene(const Key&) const;
+    void aggiorna(const Key&, const Element&);
+
+    Couple<K,E>* find(const Key&);
+    const Couple<K,E>* find(const Key&) const;
+    bool tryGet(const Key&, Element&) const;
+
+    template<class... Args>
+    std::pair<Couple<K,E>*, bool> emplace(Args&&...);
+    template<class... Args>
+    std::pair<Couple<K,E>*, bool> try_emplace(const Key&, Args&&...);
+    template<class... Args>
+    std::pair<Couple<K,E>*, bool> try_emplace(Key&&, Args&&...);
+    template<class E1>
+    std::pair<Couple<K,E>*, bool> insert_or_assign(const Key&, E1&&);
+    template<class E1>
+    std::pair<Couple<K,E>*, bool> insert_or_assign(Key&&, E1&&);
 
     void clear();
-    int getSize() const {return bucketsUsed;}
+    int lunghezza() const {return numElementi;}
     VectorList<K> keys() const;
     VectorList<E> values() const;
 
-    OpenHash<K,E>& operator=(const OpenHash<K,E>&);
-    bool operator==(const OpenHash<K,E>&) const;
-    bool operator!=(const OpenHash<K,E>&) const;
+    iterator begin() {return iterator(nodi);}
+    iterator end() {return iterator(nodi + numElementi);}
+    const_iterator begin() const {return const_iterator(nodi);}
+    const_iterator end() const {return const_iterator(nodi + numElementi);}
+    Intervallo<iterator> entries() {return Intervallo<iterator>(begin(), end());}
+    Intervallo<const_iterator> entries() const {return Intervallo<const_iterator>(begin(), end());}
+
+    OpenHash<K,E,H>& operator=(const OpenHash<K,E,H>&);
+    bool operator==(const OpenHash<K,E,H>&) const;
+    bool operator!=(const OpenHash<K,E,H>&) const;
 
-    template<class K1, class E1>
-    friend std::ostream& operator<<(std::ostream&, const OpenHash<K1,E1>&);
+    template<class K1, class E1, class H1>
+    friend std::ostream& operator<<(std::ostream&, const OpenHash<K1,E1,H1>&);
 
 private:
+    void copiaTabella(const OpenHash<K,E,H>&);
+    void liberaTabella();
+    void changeDivisore(int);
+    void changeCapacita(int);
+    template<class... Args>
+    std::pair<int, bool> inserisciSeAssente(const Key&, Args&&...);
     int calcPosition(const Key&) const;
-    VectorList<Couple<Key,Element>>* table;
+    int cercaNodo(const Key&) const;
+    int* table;             // indice del primo nodo di ogni catena, -1 se vuota
+    NodoCatena<K,E>* nodi;  // pool dei nodi, occupato nelle posizioni [0, numElementi)
+    int capacita;           // numero di nodi allocati nel pool
     int numElementi;        // numeri Elementi
-    int divisore;         // divisore
-    Hash<Key> hash;
+    int divisore;           // divisore
+    H hash;
 };
-
-template<class K, class E>
-OpenHash<K,E>::OpenHash() {
+/**
+ * @brief Costruttore di default che inizializza un dizionario con 20 bucket.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+OpenHash<K,E,H>::OpenHash() : OpenHash(20) {}
+/**
+ * @brief Costruttore che inizializza un dizionario con n bucket.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param n numero di bucket.
+ */
+template<class K, class E, class H>
+OpenHash<K,E,H>::OpenHash(int n) {
+    if (n <= 0)
+        throw std::invalid_argument("Error: il numero di bucket deve essere positivo.");
     numElementi = 0;
-    divisore = 20;
-    table = new VectorList<Couple<Key,Element>>[divisore];
+    divisore = n;
+    table = new int[divisore];
+    for (int i = 0; i < divisore; i++)
+        table[i] = -1;
+    nodi = nullptr;
+    capacita = 0;
+}
+/**
+ * @brief Costruttore di copia.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param o dizionario da copiare.
+ */
+template<class K, class E, class H>
+OpenHash<K,E,H>::OpenHash(const OpenHash& o) {
+    copiaTabella(o);
+}
+/**
+ * @brief Distruttore.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+OpenHash<K,E,H>::~OpenHash() {
+    liberaTabella();
+}
+/**
+ * @brief Metodo che controlla se il dizionario è vuoto.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return true se il dizionario è vuoto, false altrimenti.
+ */
+template<class K, class E, class H>
+bool OpenHash<K,E,H>::dizionarioVuoto() const {
+    return numElementi == 0;
 }
-template<class K, class E>
-OpenHash<K,E>::OpenHash(int n) {
+/**
+ * @brief Metodo che inserisce una coppia < K, E > in testa alla catena del proprio bucket.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param couple coppia da copiare nel dizionario.
+ */
+template<class K, class E, class H>
+void OpenHash<K,E,H>::inserisci(const Couple<Key,Element>& couple) {
+    if (!inserisciSeAssente(couple.getKey(), couple).second)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+}
+/**
+ * @brief Metodo che inserisce una coppia < K, E > nel dizionario spostandola.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param couple coppia da spostare nel dizionario; non viene modificata se la
+ * chiave è già presente.
+ */
+template<class K, class E, class H>
+void OpenHash<K,E,H>::inserisci(Couple<Key,Element>&& couple) {
+    if (!inserisciSeAssente(couple.getKey(), std::move(couple)).second)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+}
+/**
+ * @brief Metodo che costruisce una coppia con gli argomenti args e la inserisce
+ * se la sua chiave non è già presente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param args argomenti del costruttore di Couple<K, E>.
+ * @return puntatore alla coppia con la chiave indicata e true se è stata inserita,
+ * false se era già presente (in tal caso il dizionario non viene modificato).
+ */
+template<class K, class E, class H>
+template<class... Args>
+std::pair<Couple<K,E>*, bool> OpenHash<K,E,H>::emplace(Args&&... args) {
+    Couple<K,E> c(std::forward<Args>(args)...);
+    std::pair<int, bool> r = inserisciSeAssente(c.getKey(), std::move(c));
+    return {&nodi[r.first].coppia, r.second};
+}
+/**
+ * @brief Metodo che inserisce una coppia con chiave key ed elemento costruito con
+ * gli argomenti args, solo se la chiave non è già presente.
+ * Se la chiave è presente gli argomenti non vengono utilizzati.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param args argomenti del costruttore dell'elemento.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita, false altrimenti.
+ */
+template<class K, class E, class H>
+template<class... Args>
+std::pair<Couple<K,E>*, bool> OpenHash<K,E,H>::try_emplace(const Key& key, Args&&... args) {
+    std::pair<int, bool> r = inserisciSeAssente(key, std::piecewise_construct, key, std::forward<Args>(args)...);
+    return {&nodi[r.first].coppia, r.second};
+}
+/**
+ * @brief Versione di try_emplace che sposta la chiave nella coppia inserita.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave, spostata solo se la coppia viene inserita.
+ * @param args argomenti del costruttore dell'elemento.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita, false altrimenti.
+ */
+template<class K, class E, class H>
+template<class... Args>
+std::pair<Couple<K,E>*, bool> OpenHash<K,E,H>::try_emplace(Key&& key, Args&&... args) {
+    std::pair<int, bool> r = inserisciSeAssente(key, std::piecewise_construct, std::move(key), std::forward<Args>(args)...);
+    return {&nodi[r.first].coppia, r.second};
+}
+/**
+ * @brief Metodo che inserisce la coppia < key, element > oppure, se la chiave è già
+ * presente, le assegna element.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param element elemento da inserire o assegnare.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita, false se
+ * è stata aggiornata.
+ */
+template<class K, class E, class H>
+template<class E1>
+std::pair<Couple<K,E>*, bool> OpenHash<K,E,H>::insert_or_assign(const Key& key, E1&& element) {
+    std::pair<int, bool> r = inserisciSeAssente(key, std::piecewise_construct, key, std::forward<E1>(element));
+    if (!r.second)
+        nodi[r.first].coppia.getElement() = std::forward<E1>(element);
+    return {&nodi[r.first].coppia, r.second};
+}
+/**
+ * @brief Versione di insert_or_assign che sposta la chiave nella coppia inserita.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave, spostata solo se la coppia viene inserita.
+ * @param element elemento da inserire o assegnare.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita, false se
+ * è stata aggiornata.
+ */
+template<class K, class E, class H>
+template<class E1>
+std::pair<Couple<K,E>*, bool> OpenHash<K,E,H>::insert_or_assign(Key&& key, E1&& element) {
+    std::pair<int, bool> r = inserisciSeAssente(key, std::piecewise_construct, std::move(key), std::forward<E1>(element));
+    if (!r.second)
+        nodi[r.first].coppia.getElement() = std::forward<E1>(element);
+    return {&nodi[r.first].coppia, r.second};
+}
+/**
+ * @brief Metodo che rimuove una coppia < K, E > dal dizionario.
+ * Il nodo liberato viene occupato dall'ultimo nodo del pool, in modo da mantenere
+ * il pool compatto.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param k chiave.
+ */
+template <class K, class E, class H>
+void OpenHash<K,E,H>::cancella(const Key& k) {
+    if (dizionarioVuoto())
+        throw std::out_of_range("Il dizionario è vuoto.");
+
+    // Scollega il nodo dalla propria catena
+    int* link = &table[calcPosition(k)];
+    while (*link != -1 && !(nodi[*link].coppia.getKey() == k))
+        link = &nodi[*link].successivo;
+    if (*link == -1)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    int i = *link;
+    *link = nodi[i].successivo;
+    nodi[i].~NodoCatena<K,E>();
+
+    // Sposta l'ultimo nodo del pool nella posizione liberata
+    int ultimo = numElementi - 1;
+    if (i != ultimo) {
+        link = &table[calcPosition(nodi[ultimo].coppia.getKey())];
+        while (*link != ultimo)
+            link = &nodi[*link].successivo;
+        *link = i;
+        new (&nodi[i]) NodoCatena<K,E>(std::move(nodi[ultimo]));
+        nodi[ultimo].~NodoCatena<K,E>();
+    }
+    numElementi--;
+}
+/**
+ * @brief Metodo che restituisce l'elemento associato alla chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @return elemento associato alla chiave key.
+ */
+template<class K, class E, class H>
+typename OpenHash<K,E,H>::Element OpenHash<K,E,H>::recupera(const Key& key) const {
+    if (dizionarioVuoto())
+        throw std::out_of_range("Il dizionario è vuoto.");
+
+    int i = cercaNodo(key);
+    if (i == -1)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    return nodi[i].coppia.getElement();
+}
+/**
+ * @brief Metodo che verifica se il dizionario contiene una coppia con chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @return true se il dizionario contiene una coppia con chiave key, false altrimenti.
+ */
+template<class K, class E, class H>
+bool OpenHash<K,E,H>::appartiene(const Key& key) const {
+    return cercaNodo(key) != -1;
+}
+/**
+ * @brief Metodo che aggiorna il valore associato a una chiave esistente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param element nuovo elemento.
+ */
+template<class K, class E, class H>
+void OpenHash<K,E,H>::aggiorna(const Key& key, const Element& element) {
+    if (dizionarioVuoto())
+        throw std::out_of_range("Il dizionario è vuoto.");
+
+    int i = cercaNodo(key);
+    if (i == -1)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    nodi[i].coppia.setElement(element);
+}
+/**
+ * @brief Metodo che cerca la coppia con chiave key senza sollevare eccezioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia con chiave key, nullptr se la chiave non è presente.
+ */
+template<class K, class E, class H>
+Couple<K,E>* OpenHash<K,E,H>::find(const Key& key) {
+    int i = cercaNodo(key);
+    return i == -1 ? nullptr : &nodi[i].coppia;
+}
+/**
+ * @brief Versione costante di find.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia con chiave key, nullptr se la chiave non è presente.
+ */
+template<class K, class E, class H>
+const Couple<K,E>* OpenHash<K,E,H>::find(const Key& key) const {
+    int i = cercaNodo(key);
+    return i == -1 ? nullptr : &nodi[i].coppia;
+}
+/**
+ * @brief Metodo che recupera l'elemento associato a key senza sollevare eccezioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param element parametro di uscita in cui copiare l'elemento trovato.
+ * @return true se la chiave è presente, false altrimenti (element non viene modificato).
+ */
+template<class K, class E, class H>
+bool OpenHash<K,E,H>::tryGet(const Key& key, Element& element) const {
+    int i = cercaNodo(key);
+    if (i == -1)
+        return false;
+    element = nodi[i].coppia.getElement();
+    return true;
+}
+/**
+ * @brief Metodo che resetta il dizionario. Il pool dei nodi resta allocato.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+void OpenHash<K,E,H>::clear() {
+    for (int i = 0; i < numElementi; i++)
+        nodi[i].~NodoCatena<K,E>();
+    for (int i = 0; i < divisore; i++)
+        table[i] = -1;
     numElementi = 0;
-    divisore = n;
-    table = new VectorList<Couple<Key,Element>>[divisore];
 }
-template<class K, class E>
-OpenHash<K,E>::OpenHash(const OpenHash& o) {
+/**
+ * @brief Metodo che restituisce una lista contenente tutte le chiavi del dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutte le chiavi del dizionario.
+ */
+template <class K, class E, class H>
+VectorList<K> OpenHash<K,E,H>::keys() const {
+    VectorList<K> keys;
+    for (int i = 0; i < numElementi; i++)
+        keys.inserisciCoda(nodi[i].coppia.getKey());
+    return keys;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutti gli elementi del dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutti gli elementi del dizionario.
+ */
+template <class K, class E, class H>
+VectorList<E> OpenHash<K,E,H>::values() const {
+    VectorList<E> values;
+    for (int i = 0; i < numElementi; i++)
+        values.inserisciCoda(nodi[i].coppia.getElement());
+    return values;
+}
+/**
+ * @brief Operatore di assegnamento.
+ * Bucket e pool di o vengono copiati prima di rilasciare quelli attuali: se la
+ * copia fallisce, il dizionario resta invariato.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param o dizionario da assegnare.
+ * @return il dizionario assegnato.
+ */
+template<class K, class E, class H>
+OpenHash<K,E,H>& OpenHash<K,E,H>::operator=(const OpenHash<K,E,H>& o) {
+    if (this != &o) {
+        int* vecchiaTabella = table;
+        NodoCatena<K,E>* vecchiNodi = nodi;
+        int vecchiElementi = numElementi;
+        copiaTabella(o);
+        for (int i = 0; i < vecchiElementi; i++)
+            vecchiNodi[i].~NodoCatena<K,E>();
+        ::operator delete(vecchiNodi);
+        delete[] vecchiaTabella;
+    }
+    return *this;
+}
+/**
+ * @brief Operatore di uguaglianza.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param o dizionario da confrontare.
+ * @return true se i dizionari contengono le stesse chiavi, false altrimenti.
+ */
+template <class K, class E, class H>
+bool OpenHash<K,E,H>::operator==(const OpenHash<K,E,H>& o) const {
+    if (this->lunghezza() != o.lunghezza())
+        return false;
+    for (int i = 0; i < numElementi; i++) {
+        if (!o.appartiene(nodi[i].coppia.getKey()))
+            return false;
+    }
+    return true;
+}
+/**
+ * @brief Operatore di disuguaglianza.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param o dizionario da confrontare.
+ * @return true se i dizionari sono diversi, false altrimenti.
+ */
+template <class K, class E, class H>
+bool OpenHash<K,E,H>::operator!=(const OpenHash<K,E,H>& o) const {
+    return !(*this == o);
+}
+/**
+ * @brief Operatore di stream.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param os stream di output.
+ * @param o dizionario da stampare.
+ * @return stream di output.
+ */
+template <class K, class E, class H>
+ostream& operator<<(ostream& os, const OpenHash<K,E,H>& o) {
+    os << "{";
+    for (int i = 0; i < o.numElementi; i++) {
+        if (i != 0)
+            os << ", ";
+        os << o.nodi[i].coppia.getKey() << ": " << o.nodi[i].coppia.getElement();
+    }
+    os << "}";
+    return os;
+}
+/**
+ * @brief Metodo che copia bucket e pool di o, con le stesse catene.
+ * I membri vengono sovrascritti solo dopo che la copia è riuscita: bucket e pool
+ * precedenti, se esistono, restano al chiamante. Se la copia fallisce, i nodi già
+ * copiati vengono distrutti e la memoria rilasciata.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param o dizionario da copiare.
+ */
+template <class K, class E, class H>
+void OpenHash<K,E,H>::copiaTabella(const OpenHash<K,E,H>& o) {
+    int* nuovaTabella = new int[o.divisore];
+    for (int i = 0; i < o.divisore; i++)
+        nuovaTabella[i] = o.table[i];
+    NodoCatena<K,E>* nuoviNodi = nullptr;
+    int copiati = 0;
+    try {
+        nuoviNodi = static_cast<NodoCatena<K,E>*>(::operator new(sizeof(NodoCatena<K,E>) * o.numElementi));
+        for (; copiati < o.numElementi; copiati++)
+            new (&nuoviNodi[copiati]) NodoCatena<K,E>(o.nodi[copiati]);
+    } catch (...) {
+        for (int i = 0; i < copiati; i++)
+            nuoviNodi[i].~NodoCatena<K,E>();
+        ::operator delete(nuoviNodi);
+        delete[] nuovaTabella;
+        throw;
+    }
+    table = nuovaTabella;
+    nodi = nuoviNodi;
+    capacita = o.numElementi;
     numElementi = o.numElementi;
     divisore = o.divisore;
-    table = new VectorList<Couple<Key,Element>>[divisore];
-    for(int i = 0; i < divisore; i++)
-        table[i] = o.table[i];
 }
-template<class K, class E>
-OpenHash<K,E>::~OpenHash() {
+/**
+ * @brief Metodo che distrugge i nodi e rilascia bucket e pool.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class H>
+void OpenHash<K,E,H>::liberaTabella() {
+    for (int i = 0; i < numElementi; i++)
+        nodi[i].~NodoCatena<K,E>();
+    ::operator delete(nodi);
     delete[] table;
 }
-template<class K, class E>
-bool OpenHash<K,E>::isEmpty() const {
-    return numElementi == 0;
-}
-template<class K, class E>
-void OpenHash<K,E>::insert(Couple<Key,Element>& couple) {
-    int position = calcPosition(couple.getKey());
-
-    if (containsKey(couple.getKey())) {
-        throw std::invalid_argument("Chiave già presente");
-    } else {
-        // Se non è presente una coppia identica nella lista in posizione "position",
-        // inserisco la coppia in fondo alla lista.
-        if (!table[position].ricercaElemento(couple)) {
-            table[position].inserisciCoda(couple);
-            numElementi++;
-        }
+/**
+ * @brief Metodo che modifica il numero di bucket e ricollega le catene.
+ * Le coppie restano nel pool: vengono aggiornati solo gli indici.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param newDiv nuovo numero di bucket.
+ */
+template <class K, class E, class H>
+void OpenHash<K,E,H>::changeDivisore(int newDiv) {
+    delete[] table;
+    divisore = newDiv;
+    table = new int[divisore];
+    for (int i = 0; i < divisore; i++)
+        table[i] = -1;
+    for (int i = 0; i < numElementi; i++) {
+        int position = calcPosition(nodi[i].coppia.getKey());
+        nodi[i].successivo = table[position];
+        table[position] = i;
     }
 }
-template <class K, class E>
-void OpenHash<K,E>::remove(const Key& k) {
-    if (!isEmpty() && containsKey(k)) {
-        int i = hash(k) % divisore;
-        posizione p = table[i].primoLista();
-        while (table[i].leggiLista())
+/**
+ * @brief Metodo che modifica il numero di nodi allocati nel pool.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param newCap nuova capacità del pool, non inferiore al numero di coppie.
+ */
+template <class K, class E, class H>
+void OpenHash<K,E,H>::changeCapacita(int newCap) {
+    NodoCatena<K,E>* newNodi = static_cast<NodoCatena<K,E>*>(::operator new(sizeof(NodoCatena<K,E>) * newCap));
+    for (int i = 0; i < numElementi; i++) {
+        new (&newNodi[i]) NodoCatena<K,E>(std::move(nodi[i]));
+        nodi[i].~NodoCatena<K,E>();
     }
-
+    ::operator delete(nodi);
+    nodi = newNodi;
+    capacita = newCap;
 }
+/**
+ * @brief Metodo che inserisce in testa alla catena del proprio bucket una coppia
+ * costruita con gli argomenti args, se la chiave key non è già presente.
+ * La coppia viene costruita direttamente nel pool, dopo l'ultimo utilizzo di key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia da inserire.
+ * @param args argomenti del costruttore di Couple<K, E>.
+ * @return indice del nodo contenente la chiave key e true se la coppia è stata
+ * inserita, false se la chiave era già presente.
+ */
+template <class K, class E, class H>
+template <class... Args>
+std::pair<int, bool> OpenHash<K,E,H>::inserisciSeAssente(const Key& key, Args&&... args) {
+    int i = cercaNodo(key);
+    if (i != -1)
+        return {i, false};
 
+    if (numElementi == capacita)
+        changeCapacita(capacita < 8 ? 8 : capacita * 2);
+    if (numElementi >= divisore)
+        changeDivisore(divisore * 2);
 
-
-template<class K, class E>
-int OpenHash<K,E>::calcPosition(const Key& k) const {
-    int pos = (int) hash(k) % divisore;
-    return pos;
+    int position = calcPosition(key);
+    new (&nodi[numElementi]) NodoCatena<K,E>(table[position], std::forward<Args>(args)...);
+    table[position] = numElementi;
+    return {numElementi++, true};
+}
+/**
+ * @brief Metodo che calcola il bucket associato a una chiave.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param k chiave.
+ * @return indice del bucket.
+ */
+template<class K, class E, class H>
+int OpenHash<K,E,H>::calcPosition(const Key& k) const {
+    return static_cast<int>(hash(k) % divisore);
+}
+/**
+ * @brief Metodo che individua il nodo contenente la chiave k scorrendone la catena.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param k chiave da cercare.
+ * @return indice del nodo nel pool, -1 se la chiave non è presente.
+ */
+template<class K, class E, class H>
+int OpenHash<K,E,H>::cercaNodo(const Key& k) const {
+    for (int i = table[calcPosition(k)]; i != -1; i = nodi[i].successivo) {
+        if (nodi[i].coppia.getKey() == k)
+            return i;
+    }
+    return -1;
 }
 
 #endif //DICTIONARY_OPENHASH_H
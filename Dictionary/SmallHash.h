@@ -0,0 +1,417 @@
+#ifndef DICTIONARY_SMALLHASH_H
+#define DICTIONARY_SMALLHASH_H
+
+#include "ClosedHash.h"
+#include "Dictionary.h"
+#include "Hash.h"
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief Classe che rappresenta un dizionario pensato per contenere poche coppie.
+ * Fino a N coppie sono memorizzate direttamente all'interno dell'oggetto, senza
+ * alcuna allocazione, e le ricerche confrontano le chiavi in sequenza: con poche
+ * coppie contigue una scansione costa meno del calcolo dell'hash.
+ * <br>
+ * Quando si inserisce la coppia N + 1 le coppie vengono spostate in un ClosedHash
+ * allocato sul momento, al quale sono delegate tutte le operazioni successive.
+ * Il dizionario torna alla memorizzazione interna solo con clear(): le cancellazioni
+ * non lo riportano indietro, per non alternare le due rappresentazioni quando la
+ * lunghezza oscilla intorno a N.
+ * <br>
+ * Un dizionario vuoto non alloca memoria.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam N numero massimo di coppie memorizzate all'interno dell'oggetto.
+ * @tparam H funzione hash della tabella usata oltre N coppie, per default Hash<K>.
+ */
+template <class K, class E, int N = 4, class H = Hash<K>>
+class SmallHash : public Dictionary<K,E> {
+    static_assert(N > 0, "SmallHash richiede almeno una coppia interna");
+
+public:
+    typedef typename Dictionary<K,E>::Key Key;
+    typedef typename Dictionary<K,E>::Element Element;
+
+    SmallHash() : numLocali(0), tabella(nullptr) {}
+    SmallHash(const SmallHash&);
+    ~SmallHash();
+
+    bool dizionarioVuoto() const {return lunghezza() == 0;}
+    void inserisci(const Couple<Key,Element>&);
+    void inserisci(Couple<Key,Element>&&);
+    void cancella(const Key&);
+    Element recupera(const Key&) const;
+    bool appartiene(const Key&) const;
+    void aggiorna(const Key&, const Element&);
+
+    Couple<K,E>* find(const Key&);
+    const Couple<K,E>* find(const Key&) const;
+    bool tryGet(const Key&, Element&) const;
+
+    template<class... Args>
+    std::pair<Couple<K,E>*, bool> try_emplace(const Key&, Args&&...);
+    template<class E1>
+    std::pair<Couple<K,E>*, bool> insert_or_assign(const Key&, E1&&);
+
+    void clear();
+    int lunghezza() const {return tabella != nullptr ? tabella->lunghezza() : numLocali;}
+    bool inLinea() const {return tabella == nullptr;}
+    VectorList<K> keys() const;
+    VectorList<E> values() const;
+
+    SmallHash& operator=(const SmallHash&);
+    bool operator==(const SmallHash&) const;
+    bool operator!=(const SmallHash&) const;
+
+private:
+    Couple<K,E>* locali() {return reinterpret_cast<Couple<K,E>*>(spazio);}
+    const Couple<K,E>* locali() const {return reinterpret_cast<const Couple<K,E>*>(spazio);}
+    int cercaLocale(const Key&) const;
+    void passaATabella();
+    void copia(const SmallHash&);
+
+    alignas(Couple<K,E>) unsigned char spazio[N * sizeof(Couple<K,E>)];    // coppie interne
+    int numLocali;                  // coppie interne costruite, in spazio[0, numLocali)
+    ClosedHash<K,E,H>* tabella;     // nullptr finché le coppie sono interne
+};
+/**
+ * @brief Costruttore copia.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param d dizionario da copiare.
+ */
+template <class K, class E, int N, class H>
+SmallHash<K,E,N,H>::SmallHash(const SmallHash& d) : numLocali(0), tabella(nullptr) {
+    copia(d);
+}
+/**
+ * @brief Distruttore.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, int N, class H>
+SmallHash<K,E,N,H>::~SmallHash() {
+    clear();
+}
+/**
+ * @brief Metodo che copia le coppie di d in un dizionario vuoto.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param d dizionario da copiare.
+ */
+template <class K, class E, int N, class H>
+void SmallHash<K,E,N,H>::copia(const SmallHash& d) {
+    if (d.tabella != nullptr) {
+        tabella = new ClosedHash<K,E,H>(*d.tabella);
+        return;
+    }
+    for (; numLocali < d.numLocali; numLocali++)
+        new (&locali()[numLocali]) Couple<K,E>(d.locali()[numLocali]);
+}
+/**
+ * @brief Metodo che cerca la chiave key tra le coppie interne.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return posizione della coppia con chiave key, -1 se la chiave non è presente.
+ */
+template <class K, class E, int N, class H>
+int SmallHash<K,E,N,H>::cercaLocale(const Key& key) const {
+    const Couple<K,E>* c = locali();
+    for (int i = 0; i < numLocali; i++) {
+        if (c[i].getKey() == key)
+            return i;
+    }
+    return -1;
+}
+/**
+ * @brief Metodo che sposta le coppie interne in un ClosedHash allocato sul momento.
+ * Le coppie interne vengono distrutte solo dopo aver riempito la nuova tabella, così
+ * che un'eccezione durante gli inserimenti lasci il dizionario con le sue coppie interne.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, int N, class H>
+void SmallHash<K,E,N,H>::passaATabella() {
+    ClosedHash<K,E,H>* nuova = new ClosedHash<K,E,H>(4 * N);
+    try {
+        for (int i = 0; i < numLocali; i++)
+            nuova->inserisci(std::move(locali()[i]));
+    } catch (...) {
+        delete nuova;
+        throw;
+    }
+    for (int i = 0; i < numLocali; i++)
+        locali()[i].~Couple<K,E>();
+    numLocali = 0;
+    tabella = nuova;
+}
+/**
+ * @brief Metodo che inserisce una coppia nel dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia da inserire.
+ */
+template <class K, class E, int N, class H>
+void SmallHash<K,E,N,H>::inserisci(const Couple<Key,Element>& c) {
+    inserisci(Couple<K,E>(c));
+}
+/**
+ * @brief Metodo che inserisce una coppia nel dizionario spostandola, senza copiarla.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param c coppia da spostare nel dizionario.
+ */
+template <class K, class E, int N, class H>
+void SmallHash<K,E,N,H>::inserisci(Couple<Key,Element>&& c) {
+    if (tabella == nullptr) {
+        if (cercaLocale(c.getKey()) != -1)
+            throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+        if (numLocali < N) {
+            new (&locali()[numLocali]) Couple<K,E>(std::move(c));
+            numLocali++;
+            return;
+        }
+        passaATabella();
+    }
+    tabella->inserisci(std::move(c));
+}
+/**
+ * @brief Metodo che cancella la coppia con chiave key.
+ * Tra le coppie interne, l'ultima prende il posto di quella cancellata.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia da cancellare.
+ */
+template <class K, class E, int N, class H>
+void SmallHash<K,E,N,H>::cancella(const Key& key) {
+    if (tabella != nullptr) {
+        tabella->cancella(key);
+        return;
+    }
+    if (numLocali == 0)
+        throw std::out_of_range("Il dizionario è vuoto.");
+    int i = cercaLocale(key);
+    if (i == -1)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    numLocali--;
+    if (i != numLocali)
+        locali()[i] = std::move(locali()[numLocali]);
+    locali()[numLocali].~Couple<K,E>();
+}
+/**
+ * @brief Metodo che recupera l'elemento associato alla chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return elemento associato alla chiave.
+ */
+template <class K, class E, int N, class H>
+typename SmallHash<K,E,N,H>::Element SmallHash<K,E,N,H>::recupera(const Key& key) const {
+    const Couple<K,E>* c = find(key);
+    if (c == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    return c->getElement();
+}
+/**
+ * @brief Metodo che controlla se la chiave key è presente nel dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return true se la chiave è presente, false altrimenti.
+ */
+template <class K, class E, int N, class H>
+bool SmallHash<K,E,N,H>::appartiene(const Key& key) const {
+    return find(key) != nullptr;
+}
+/**
+ * @brief Metodo che aggiorna l'elemento associato alla chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia da aggiornare.
+ * @param element nuovo elemento.
+ */
+template <class K, class E, int N, class H>
+void SmallHash<K,E,N,H>::aggiorna(const Key& key, const Element& element) {
+    Couple<K,E>* c = find(key);
+    if (c == nullptr)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    c->setElement(element);
+}
+/**
+ * @brief Metodo che restituisce un puntatore alla coppia con chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia, nullptr se la chiave non è presente.
+ */
+template <class K, class E, int N, class H>
+Couple<K,E>* SmallHash<K,E,N,H>::find(const Key& key) {
+    if (tabella != nullptr)
+        return tabella->find(key);
+    int i = cercaLocale(key);
+    return i == -1 ? nullptr : &locali()[i];
+}
+/**
+ * @brief Versione costante di find.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia, nullptr se la chiave non è presente.
+ */
+template <class K, class E, int N, class H>
+const Couple<K,E>* SmallHash<K,E,N,H>::find(const Key& key) const {
+    if (tabella != nullptr)
+        return static_cast<const ClosedHash<K,E,H>*>(tabella)->find(key);
+    int i = cercaLocale(key);
+    return i == -1 ? nullptr : &locali()[i];
+}
+/**
+ * @brief Metodo che recupera l'elemento associato a key senza sollevare eccezioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param element riceve una copia dell'elemento, se la chiave è presente.
+ * @return true se la chiave è presente, false altrimenti.
+ */
+template <class K, class E, int N, class H>
+bool SmallHash<K,E,N,H>::tryGet(const Key& key, Element& element) const {
+    const Couple<K,E>* c = find(key);
+    if (c == nullptr)
+        return false;
+    element = c->getElement();
+    return true;
+}
+/**
+ * @brief Metodo che costruisce l'elemento a partire da args solo se key non è presente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia.
+ * @param args argomenti del costruttore dell'elemento.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita.
+ */
+template <class K, class E, int N, class H>
+template <class... Args>
+std::pair<Couple<K,E>*, bool> SmallHash<K,E,N,H>::try_emplace(const Key& key, Args&&... args) {
+    if (tabella == nullptr) {
+        int i = cercaLocale(key);
+        if (i != -1)
+            return {&locali()[i], false};
+        if (numLocali < N) {
+            Couple<K,E>* c = new (&locali()[numLocali]) Couple<K,E>(std::piecewise_construct, key, std::forward<Args>(args)...);
+            numLocali++;
+            return {c, true};
+        }
+        passaATabella();
+    }
+    return tabella->try_emplace(key, std::forward<Args>(args)...);
+}
+/**
+ * @brief Metodo che inserisce la coppia (key, element) o, se key è già presente,
+ * assegna element all'elemento esistente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia.
+ * @param element elemento da inserire o assegnare.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita.
+ */
+template <class K, class E, int N, class H>
+template <class E1>
+std::pair<Couple<K,E>*, bool> SmallHash<K,E,N,H>::insert_or_assign(const Key& key, E1&& element) {
+    std::pair<Couple<K,E>*, bool> r = try_emplace(key, std::forward<E1>(element));
+    if (!r.second)
+        r.first->getElement() = std::forward<E1>(element);
+    return r;
+}
+/**
+ * @brief Metodo che svuota il dizionario e libera l'eventuale tabella,
+ * tornando alla memorizzazione interna.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, int N, class H>
+void SmallHash<K,E,N,H>::clear() {
+    for (int i = 0; i < numLocali; i++)
+        locali()[i].~Couple<K,E>();
+    numLocali = 0;
+    delete tabella;
+    tabella = nullptr;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutte le chiavi del dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutte le chiavi del dizionario.
+ */
+template <class K, class E, int N, class H>
+VectorList<K> SmallHash<K,E,N,H>::keys() const {
+    if (tabella != nullptr)
+        return tabella->keys();
+    VectorList<K> keys;
+    for (int i = 0; i < numLocali; i++)
+        keys.inserisciCoda(locali()[i].getKey());
+    return keys;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutti gli elementi del dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutti gli elementi del dizionario.
+ */
+template <class K, class E, int N, class H>
+VectorList<E> SmallHash<K,E,N,H>::values() const {
+    if (tabella != nullptr)
+        return tabella->values();
+    VectorList<E> values;
+    for (int i = 0; i < numLocali; i++)
+        values.inserisciCoda(locali()[i].getElement());
+    return values;
+}
+/**
+ * @brief Operatore di assegnamento.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param d dizionario da assegnare.
+ * @return riferimento al dizionario.
+ */
+template <class K, class E, int N, class H>
+SmallHash<K,E,N,H>& SmallHash<K,E,N,H>::operator=(const SmallHash& d) {
+    if (this != &d) {
+        clear();
+        copia(d);
+    }
+    return *this;
+}
+/**
+ * @brief Operatore di uguaglianza.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param d dizionario da confrontare.
+ * @return true se i dizionari contengono le stesse chiavi, false altrimenti.
+ */
+template <class K, class E, int N, class H>
+bool SmallHash<K,E,N,H>::operator==(const SmallHash& d) const {
+    if (lunghezza() != d.lunghezza())
+        return false;
+    VectorList<K> chiavi = keys();
+    for (int p = 1; p <= chiavi.lunghezza(); p++) {
+        if (!d.appartiene(chiavi.leggiLista(p)))
+            return false;
+    }
+    return true;
+}
+/**
+ * @brief Operatore di disuguaglianza.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param d dizionario da confrontare.
+ * @return true se i dizionari sono diversi, false altrimenti.
+ */
+template <class K, class E, int N, class H>
+bool SmallHash<K,E,N,H>::operator!=(const SmallHash& d) const {
+    return !(*this == d);
+}
+
+#endif //DICTIONARY_SMALLHASH_H
@@ -0,0 +1,82 @@
+#ifndef DICTIONARY_STATISTICHE_H
+#define DICTIONARY_STATISTICHE_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief Struttura che raccoglie lo stato interno di una tabella hash in un dato istante.
+ * I campi che descrivono la tabella (capacità, carico, sondaggi) sono sempre
+ * disponibili; i contatori cumulativi di ridimensionamenti e ricerche vengono
+ * aggiornati solo se la tabella è compilata con le statistiche abilitate
+ * (vedi CLOSEDHASH_STATISTICHE), altrimenti valgono 0 e contatori è false.
+ */
+struct StatisticheHash {
+    int capacita = 0;                   // numero di bucket della tabella corrente
+    int coppie = 0;
+    int cancellati = 0;                 // bucket marcati come cancellati
+    double fattoreCarico = 0;           // (coppie + cancellati) / capacita
+    int sondaggioMassimo = 0;
+    double sondaggioMedio = 0;
+    std::vector<int> istogramma;        // istogramma[d]: coppie con lunghezza di sondaggio d
+    bool trasferimentoInCorso = false;
+
+    bool contatori = false;             // true se i contatori seguenti sono aggiornati
+    uint64_t ridimensionamenti = 0;     // ricostruzioni della tabella, complete o avviate
+    double secondiRidimensionamenti = 0;
+    uint64_t ricercheRiuscite = 0;
+    uint64_t ricercheFallite = 0;
+
+    void scriviTesto(std::ostream&) const;
+    void scriviJson(std::ostream&) const;
+};
+/**
+ * @brief Metodo che scrive le statistiche in formato testuale, una per riga.
+ * @param os stream di uscita.
+ */
+inline void StatisticheHash::scriviTesto(std::ostream& os) const {
+    os << "capacita: " << capacita << "\n"
+       << "coppie: " << coppie << "\n"
+       << "cancellati: " << cancellati << "\n"
+       << "fattore di carico: " << fattoreCarico << "\n"
+       << "sondaggio massimo: " << sondaggioMassimo << "\n"
+       << "sondaggio medio: " << sondaggioMedio << "\n"
+       << "istogramma sondaggi:";
+    for (int n : istogramma)
+        os << " " << n;
+    os << "\n"
+       << "trasferimento in corso: " << (trasferimentoInCorso ? "si" : "no") << "\n";
+    if (!contatori) {
+        os << "contatori: disabilitati\n";
+        return;
+    }
+    os << "ridimensionamenti: " << ridimensionamenti << "\n"
+       << "tempo ridimensionamenti (s): " << secondiRidimensionamenti << "\n"
+       << "ricerche riuscite: " << ricercheRiuscite << "\n"
+       << "ricerche fallite: " << ricercheFallite << "\n";
+}
+/**
+ * @brief Metodo che scrive le statistiche come un oggetto JSON su una sola riga.
+ * @param os stream di uscita.
+ */
+inline void StatisticheHash::scriviJson(std::ostream& os) const {
+    os << "{\"capacita\":" << capacita
+       << ",\"coppie\":" << coppie
+       << ",\"cancellati\":" << cancellati
+       << ",\"fattoreCarico\":" << fattoreCarico
+       << ",\"sondaggioMassimo\":" << sondaggioMassimo
+       << ",\"sondaggioMedio\":" << sondaggioMedio
+       << ",\"istogramma\":[";
+    for (size_t d = 0; d < istogramma.size(); d++)
+        os << (d == 0 ? "" : ",") << istogramma[d];
+    os << "],\"trasferimentoInCorso\":" << (trasferimentoInCorso ? "true" : "false")
+       << ",\"contatori\":" << (contatori ? "true" : "false")
+       << ",\"ridimensionamenti\":" << ridimensionamenti
+       << ",\"secondiRidimensionamenti\":" << secondiRidimensionamenti
+       << ",\"ricercheRiuscite\":" << ricercheRiuscite
+       << ",\"ricercheFallite\":" << ricercheFallite
+       << "}";
+}
+
+#endif //DICTIONARY_STATISTICHE_H
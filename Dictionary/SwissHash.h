@@ -0,0 +1,850 @@
+#ifndef DICTIONARY_SWISSHASH_H
+#define DICTIONARY_SWISSHASH_H
+
+#include "Dictionary.h"
+#include "Hash.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Selezione a tempo di compilazione del confronto dei gruppi di controllo.
+// Definendo SWISSHASH_SCALARE si forza la versione scalare.
+#if !defined(SWISSHASH_SCALARE) && defined(__AVX2__)
+#include <immintrin.h>
+#define SWISSHASH_AVX2
+#elif !defined(SWISSHASH_SCALARE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define SWISSHASH_SSE2
+#endif
+
+/**
+ * @brief Classe che rappresenta un dizionario implementato con hash chiuso a gruppi
+ * (schema "Swiss table").
+ * I bucket sono suddivisi in gruppi consecutivi di GRUPPO bucket. Per ogni bucket
+ * viene mantenuto un byte di controllo: un bucket vuoto o cancellato ha il bit più
+ * significativo a 1, un bucket occupato contiene i 7 bit meno significativi dell'hash
+ * della chiave (impronta).
+ * <br>
+ * La ricerca confronta in una sola istruzione l'impronta della chiave con tutti i
+ * byte di controllo di un gruppo (SSE2 con gruppi da 16 byte, AVX2 con gruppi da 32
+ * byte, un ciclo scalare se nessuna delle due è disponibile) e confronta le chiavi
+ * solo nei bucket la cui impronta coincide. La sequenza di sondaggio si sposta di
+ * gruppo in gruppo e termina al primo gruppo che contiene un bucket vuoto.
+ * <br>
+ * Le coppie si possono visitare senza copiarle con un ciclo for sul dizionario o su
+ * entries(): ogni operazione di modifica invalida gli iteratori.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @tparam H funzione hash, per default Hash<K>.
+ */
+template <class K, class E, class H = Hash<K>>
+class SwissHash : public Dictionary<K,E> {
+public:
+    typedef typename Dictionary<K,E>::Key Key;
+    typedef typename Dictionary<K,E>::Element Element;
+
+#if defined(SWISSHASH_AVX2)
+    static const int GRUPPO = 32;
+#else
+    static const int GRUPPO = 16;
+#endif
+
+    /**
+     * @brief Iteratore in avanti sulle coppie del dizionario.
+     * @tparam Costante true per un iteratore che non consente di modificare le coppie.
+     */
+    template <bool Costante>
+    class Iteratore {
+        typedef typename std::conditional<Costante, const SwissHash, SwissHash>::type Tabella;
+        typedef typename std::conditional<Costante, const Couple<K,E>, Couple<K,E>>::type Voce;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Couple<K,E> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Voce* pointer;
+        typedef Voce& reference;
+
+        Iteratore() : d(nullptr), i(0) {}
+        Iteratore(const Iteratore<false>& it) : d(it.d), i(it.i) {}
+
+        reference operator*() const {return d->buckets[i];}
+        pointer operator->() const {return &d->buckets[i];}
+        Iteratore& operator++() {
+            i = d->prossimo(i + 1);
+            return *this;
+        }
+        Iteratore operator++(int) {
+            Iteratore it = *this;
+            ++*this;
+            return it;
+        }
+        bool operator==(const Iteratore& it) const {return i == it.i;}
+        bool operator!=(const Iteratore& it) const {return i != it.i;}
+
+    private:
+        friend class SwissHash;
+        template <bool> friend class Iteratore;
+        Iteratore(Tabella* d, int i) : d(d), i(i) {}
+
+        Tabella* d;
+        int i;          // bucket corrente
+    };
+    typedef Iteratore<false> iterator;
+    typedef Iteratore<true> const_iterator;
+
+    SwissHash();
+    SwissHash(int);
+    SwissHash(const SwissHash&);
+    ~SwissHash();
+
+    bool dizionarioVuoto() const;
+    void inserisci(const Couple<Key,Element>&);
+    void inserisci(Couple<Key,Element>&&);
+    void cancella(const Key&);
+    Element recupera(const Key&) const;
+    bool appartiene(const Key&) const;
+    void aggiorna(const Key&, const Element&);
+
+    Couple<K,E>* find(const Key&);
+    const Couple<K,E>* find(const Key&) const;
+    bool tryGet(const Key&, Element&) const;
+
+    template<class... Args>
+    std::pair<Couple<K,E>*, bool> emplace(Args&&...);
+    template<class... Args>
+    std::pair<Couple<K,E>*, bool> try_emplace(const Key&, Args&&...);
+    template<class... Args>
+    std::pair<Couple<K,E>*, bool> try_emplace(Key&&, Args&&...);
+    template<class E1>
+    std::pair<Couple<K,E>*, bool> insert_or_assign(const Key&, E1&&);
+    template<class E1>
+    std::pair<Couple<K,E>*, bool> insert_or_assign(Key&&, E1&&);
+
+    void clear();
+    int lunghezza() const {return bucketsUsed;}
+    int cancellati() const {return bucketsDeleted;}
+    VectorList<K> keys() const;
+    VectorList<E> values() const;
+
+    iterator begin() {return iterator(this, prossimo(0));}
+    iterator end() {return iterator(this, numGruppi * GRUPPO);}
+    const_iterator begin() const {return const_iterator(this, prossimo(0));}
+    const_iterator end() const {return const_iterator(this, numGruppi * GRUPPO);}
+    Intervallo<iterator> entries() {return Intervallo<iterator>(begin(), end());}
+    Intervallo<const_iterator> entries() const {return Intervallo<const_iterator>(begin(), end());}
+
+    SwissHash<K,E,H>& operator=(const SwissHash<K,E,H>&);
+    bool operator==(const SwissHash<K,E,H>&) const;
+    bool operator!=(const SwissHash<K,E,H>&) const;
+
+    template<class K1, class E1, class H1>
+    friend std::ostream& operator<<(std::ostream&, const SwissHash<K1,E1,H1>&);
+
+private:
+    typedef unsigned int Maschera;                  // un bit per ogni bucket del gruppo
+
+    static const unsigned char VUOTO = 0x80;        // bucket mai occupato
+    static const unsigned char CANCELLATO = 0xFE;   // bucket liberato da una cancellazione
+
+    static Maschera corrisponde(const unsigned char*, unsigned char);
+    static Maschera liberi(const unsigned char*);
+    static int primoBit(Maschera);
+
+    void allocaBuckets(int);
+    void liberaBuckets();
+    void copiaBuckets(const SwissHash<K,E,H>&);
+    void changeGruppi(int);
+    template<class... Args>
+    std::pair<int, bool> inserisciSeAssente(const Key&, Args&&...);
+    size_t calcHash(const Key&) const;
+    int cercaSlot(const Key&, size_t) const;
+    int cercaLibero(size_t) const;
+    int prossimo(int) const;
+    Couple<K,E>* buckets;   // coppie memorizzate in linea
+    unsigned char* stato;   // byte di controllo, uno per bucket
+    int bucketsUsed;        // numero di coppie
+    int bucketsDeleted;     // bucket marcati come cancellati
+    int numGruppi;          // numero di gruppi, potenza di 2
+    H hash;
+};
+/**
+ * @brief Costruttore di default che inizializza un dizionario con un solo gruppo.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+SwissHash<K,E,H>::SwissHash() {
+    bucketsUsed = 0;
+    bucketsDeleted = 0;
+    allocaBuckets(1);
+}
+/**
+ * @brief Costruttore che inizializza un dizionario in grado di contenere n coppie
+ * senza ridimensionamenti.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param n numero di coppie previste.
+ */
+template<class K, class E, class H>
+SwissHash<K,E,H>::SwissHash(int n) {
+    if (n <= 0)
+        throw std::invalid_argument("Error: il numero di coppie previste deve essere positivo.");
+    int gruppi = 1;
+    while ((double)gruppi * GRUPPO * 0.875 < n)
+        gruppi *= 2;
+    bucketsUsed = 0;
+    bucketsDeleted = 0;
+    allocaBuckets(gruppi);
+}
+/**
+ * @brief Costruttore di copia.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param h dizionario da copiare.
+ */
+template<class K, class E, class H>
+SwissHash<K,E,H>::SwissHash(const SwissHash& h) {
+    copiaBuckets(h);
+}
+/**
+ * @brief Distruttore.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+SwissHash<K,E,H>::~SwissHash() {
+    liberaBuckets();
+}
+/**
+ * @brief Metodo che controlla se il dizionario è vuoto.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return true se il dizionario è vuoto, false altrimenti.
+ */
+template<class K, class E, class H>
+bool SwissHash<K,E,H>::dizionarioVuoto() const {
+    return bucketsUsed == 0;
+}
+/**
+ * @brief Metodo che inserisce una coppia < K, E > nel dizionario.
+ * La coppia occupa il primo bucket vuoto o cancellato della sequenza di sondaggio.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param couple coppia da copiare nel dizionario.
+ */
+template<class K, class E, class H>
+void SwissHash<K,E,H>::inserisci(const Couple<Key,Element>& couple) {
+    if (!inserisciSeAssente(couple.getKey(), couple).second)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+}
+/**
+ * @brief Metodo che inserisce una coppia < K, E > nel dizionario spostandola.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param couple coppia da spostare nel dizionario; non viene modificata se la
+ * chiave è già presente.
+ */
+template<class K, class E, class H>
+void SwissHash<K,E,H>::inserisci(Couple<Key,Element>&& couple) {
+    if (!inserisciSeAssente(couple.getKey(), std::move(couple)).second)
+        throw std::runtime_error("Error: esiste gia' una coppia con la stessa chiave");
+}
+/**
+ * @brief Metodo che costruisce una coppia con gli argomenti args e la inserisce
+ * se la sua chiave non è già presente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param args argomenti del costruttore di Couple<K, E>.
+ * @return puntatore alla coppia con la chiave indicata e true se è stata inserita,
+ * false se era già presente (in tal caso il dizionario non viene modificato).
+ */
+template<class K, class E, class H>
+template<class... Args>
+std::pair<Couple<K,E>*, bool> SwissHash<K,E,H>::emplace(Args&&... args) {
+    Couple<K,E> c(std::forward<Args>(args)...);
+    std::pair<int, bool> r = inserisciSeAssente(c.getKey(), std::move(c));
+    return {&buckets[r.first], r.second};
+}
+/**
+ * @brief Metodo che inserisce una coppia con chiave key ed elemento costruito con
+ * gli argomenti args, solo se la chiave non è già presente.
+ * Se la chiave è presente gli argomenti non vengono utilizzati.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param args argomenti del costruttore dell'elemento.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita, false altrimenti.
+ */
+template<class K, class E, class H>
+template<class... Args>
+std::pair<Couple<K,E>*, bool> SwissHash<K,E,H>::try_emplace(const Key& key, Args&&... args) {
+    std::pair<int, bool> r = inserisciSeAssente(key, std::piecewise_construct, key, std::forward<Args>(args)...);
+    return {&buckets[r.first], r.second};
+}
+/**
+ * @brief Versione di try_emplace che sposta la chiave nella coppia inserita.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave, spostata solo se la coppia viene inserita.
+ * @param args argomenti del costruttore dell'elemento.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita, false altrimenti.
+ */
+template<class K, class E, class H>
+template<class... Args>
+std::pair<Couple<K,E>*, bool> SwissHash<K,E,H>::try_emplace(Key&& key, Args&&... args) {
+    std::pair<int, bool> r = inserisciSeAssente(key, std::piecewise_construct, std::move(key), std::forward<Args>(args)...);
+    return {&buckets[r.first], r.second};
+}
+/**
+ * @brief Metodo che inserisce la coppia < key, element > oppure, se la chiave è già
+ * presente, le assegna element.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param element elemento da inserire o assegnare.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita, false se
+ * è stata aggiornata.
+ */
+template<class K, class E, class H>
+template<class E1>
+std::pair<Couple<K,E>*, bool> SwissHash<K,E,H>::insert_or_assign(const Key& key, E1&& element) {
+    std::pair<int, bool> r = inserisciSeAssente(key, std::piecewise_construct, key, std::forward<E1>(element));
+    if (!r.second)
+        buckets[r.first].getElement() = std::forward<E1>(element);
+    return {&buckets[r.first], r.second};
+}
+/**
+ * @brief Versione di insert_or_assign che sposta la chiave nella coppia inserita.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave, spostata solo se la coppia viene inserita.
+ * @param element elemento da inserire o assegnare.
+ * @return puntatore alla coppia con chiave key e true se è stata inserita, false se
+ * è stata aggiornata.
+ */
+template<class K, class E, class H>
+template<class E1>
+std::pair<Couple<K,E>*, bool> SwissHash<K,E,H>::insert_or_assign(Key&& key, E1&& element) {
+    std::pair<int, bool> r = inserisciSeAssente(key, std::piecewise_construct, std::move(key), std::forward<E1>(element));
+    if (!r.second)
+        buckets[r.first].getElement() = std::forward<E1>(element);
+    return {&buckets[r.first], r.second};
+}
+/**
+ * @brief Metodo che rimuove una coppia < K, E > dal dizionario.
+ * Se il gruppo del bucket contiene ancora un bucket vuoto nessuna sequenza di
+ * sondaggio lo ha mai oltrepassato, quindi il bucket torna vuoto; altrimenti
+ * viene marcato come cancellato.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ */
+template<class K, class E, class H>
+void SwissHash<K,E,H>::cancella(const Key& key) {
+    if (dizionarioVuoto())
+        throw std::out_of_range("Il dizionario è vuoto.");
+
+    int i = cercaSlot(key, calcHash(key));
+    if (i == -1)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+
+    buckets[i].~Couple<K,E>();
+    bucketsUsed--;
+    if (corrisponde(stato + (i / GRUPPO) * GRUPPO, VUOTO) != 0) {
+        stato[i] = VUOTO;
+    } else {
+        stato[i] = CANCELLATO;
+        bucketsDeleted++;
+    }
+}
+/**
+ * @brief Metodo che restituisce l'elemento associato alla chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @return elemento associato alla chiave key.
+ */
+template<class K, class E, class H>
+typename SwissHash<K,E,H>::Element SwissHash<K,E,H>::recupera(const Key& key) const {
+    if (dizionarioVuoto())
+        throw std::out_of_range("Il dizionario è vuoto.");
+
+    int i = cercaSlot(key, calcHash(key));
+    if (i == -1)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    return buckets[i].getElement();
+}
+/**
+ * @brief Metodo che verifica se il dizionario contiene una coppia con chiave key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @return true se il dizionario contiene una coppia con chiave key, false altrimenti.
+ */
+template<class K, class E, class H>
+bool SwissHash<K,E,H>::appartiene(const Key& key) const {
+    return cercaSlot(key, calcHash(key)) != -1;
+}
+/**
+ * @brief Metodo che aggiorna il valore associato a una chiave esistente.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @param element nuovo elemento.
+ */
+template<class K, class E, class H>
+void SwissHash<K,E,H>::aggiorna(const Key& key, const Element& element) {
+    if (dizionarioVuoto())
+        throw std::out_of_range("Il dizionario è vuoto.");
+
+    int i = cercaSlot(key, calcHash(key));
+    if (i == -1)
+        throw std::out_of_range("Error: la chiave non e' presente.");
+    buckets[i].setElement(element);
+}
+/**
+ * @brief Metodo che cerca la coppia con chiave key senza sollevare eccezioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia con chiave key, nullptr se la chiave non è presente.
+ */
+template<class K, class E, class H>
+Couple<K,E>* SwissHash<K,E,H>::find(const Key& key) {
+    int i = cercaSlot(key, calcHash(key));
+    return i == -1 ? nullptr : &buckets[i];
+}
+/**
+ * @brief Versione costante di find.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @return puntatore alla coppia con chiave key, nullptr se la chiave non è presente.
+ */
+template<class K, class E, class H>
+const Couple<K,E>* SwissHash<K,E,H>::find(const Key& key) const {
+    int i = cercaSlot(key, calcHash(key));
+    return i == -1 ? nullptr : &buckets[i];
+}
+/**
+ * @brief Metodo che recupera l'elemento associato a key senza sollevare eccezioni.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param element parametro di uscita in cui copiare l'elemento trovato.
+ * @return true se la chiave è presente, false altrimenti (element non viene modificato).
+ */
+template<class K, class E, class H>
+bool SwissHash<K,E,H>::tryGet(const Key& key, Element& element) const {
+    int i = cercaSlot(key, calcHash(key));
+    if (i == -1)
+        return false;
+    element = buckets[i].getElement();
+    return true;
+}
+/**
+ * @brief Metodo che resetta il dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template<class K, class E, class H>
+void SwissHash<K,E,H>::clear() {
+    for (int i = 0; i < numGruppi * GRUPPO; i++) {
+        if ((stato[i] & 0x80) == 0)
+            buckets[i].~Couple<K,E>();
+        stato[i] = VUOTO;
+    }
+    bucketsUsed = 0;
+    bucketsDeleted = 0;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutte le chiavi del dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutte le chiavi del dizionario.
+ */
+template <class K, class E, class H>
+VectorList<K> SwissHash<K,E,H>::keys() const {
+    VectorList<K> keys;
+    for (int i = 0; i < numGruppi * GRUPPO; i++) {
+        if ((stato[i] & 0x80) == 0)
+            keys.inserisciCoda(buckets[i].getKey());
+    }
+    return keys;
+}
+/**
+ * @brief Metodo che restituisce una lista contenente tutti gli elementi del dizionario.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @return lista contenente tutti gli elementi del dizionario.
+ */
+template <class K, class E, class H>
+VectorList<E> SwissHash<K,E,H>::values() const {
+    VectorList<E> values;
+    for (int i = 0; i < numGruppi * GRUPPO; i++) {
+        if ((stato[i] & 0x80) == 0)
+            values.inserisciCoda(buckets[i].getElement());
+    }
+    return values;
+}
+/**
+ * @brief Operatore di assegnamento.
+ * La tabella di mp viene copiata prima di rilasciare quella attuale: se la copia
+ * fallisce, il dizionario resta invariato.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param mp dizionario da assegnare.
+ * @return il dizionario assegnato.
+ */
+template<class K, class E, class H>
+SwissHash<K,E,H>& SwissHash<K,E,H>::operator=(const SwissHash<K,E,H>& mp) {
+    if (this != &mp) {
+        Couple<K,E>* coppie = buckets;
+        unsigned char* stati = stato;
+        int gruppi = numGruppi;
+        copiaBuckets(mp);
+        for (int i = 0; i < gruppi * GRUPPO; i++) {
+            if ((stati[i] & 0x80) == 0)
+                coppie[i].~Couple<K,E>();
+        }
+        ::operator delete(coppie);
+        delete[] stati;
+    }
+    return *this;
+}
+/**
+ * @brief Operatore di uguaglianza.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param mp dizionario da confrontare.
+ * @return true se i dizionari contengono le stesse chiavi, false altrimenti.
+ */
+template <class K, class E, class H>
+bool SwissHash<K,E,H>::operator==(const SwissHash<K,E,H>& mp) const {
+    if (this->lunghezza() != mp.lunghezza())
+        return false;
+    for (int i = 0; i < numGruppi * GRUPPO; i++) {
+        if ((stato[i] & 0x80) == 0 && !mp.appartiene(buckets[i].getKey()))
+            return false;
+    }
+    return true;
+}
+/**
+ * @brief Operatore di disuguaglianza.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param mp dizionario da confrontare.
+ * @return true se i dizionari sono diversi, false altrimenti.
+ */
+template <class K, class E, class H>
+bool SwissHash<K,E,H>::operator!=(const SwissHash<K,E,H>& mp) const {
+    return !(*this == mp);
+}
+/**
+ * @brief Operatore di stream.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param os stream di output.
+ * @param mp dizionario da stampare.
+ * @return stream di output.
+ */
+template <class K, class E, class H>
+ostream& operator<<(ostream& os, const SwissHash<K,E,H>& mp) {
+    os << "{";
+    bool primo = true;
+    for (int i = 0; i < mp.numGruppi * SwissHash<K,E,H>::GRUPPO; i++) {
+        if ((mp.stato[i] & 0x80) == 0) {
+            if (!primo)
+                os << ", ";
+            os << mp.buckets[i].getKey() << ": " << mp.buckets[i].getElement();
+            primo = false;
+        }
+    }
+    os << "}";
+    return os;
+}
+/**
+ * @brief Metodo che confronta un byte con tutti i byte di controllo di un gruppo.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param gruppo primo byte di controllo del gruppo.
+ * @param b byte da cercare.
+ * @return maschera con il bit i a 1 se il byte i del gruppo è uguale a b.
+ */
+template <class K, class E, class H>
+typename SwissHash<K,E,H>::Maschera SwissHash<K,E,H>::corrisponde(const unsigned char* gruppo, unsigned char b) {
+#if defined(SWISSHASH_AVX2)
+    __m256i ctrl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(gruppo));
+    return (Maschera)_mm256_movemask_epi8(_mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8((char)b)));
+#elif defined(SWISSHASH_SSE2)
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gruppo));
+    return (Maschera)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)b)));
+#else
+    Maschera m = 0;
+    for (int i = 0; i < GRUPPO; i++) {
+        if (gruppo[i] == b)
+            m |= (Maschera)1 << i;
+    }
+    return m;
+#endif
+}
+/**
+ * @brief Metodo che individua i bucket vuoti o cancellati di un gruppo.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param gruppo primo byte di controllo del gruppo.
+ * @return maschera con il bit i a 1 se il bucket i del gruppo è libero.
+ */
+template <class K, class E, class H>
+typename SwissHash<K,E,H>::Maschera SwissHash<K,E,H>::liberi(const unsigned char* gruppo) {
+#if defined(SWISSHASH_AVX2)
+    return (Maschera)_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(gruppo)));
+#elif defined(SWISSHASH_SSE2)
+    return (Maschera)_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(gruppo)));
+#else
+    Maschera m = 0;
+    for (int i = 0; i < GRUPPO; i++) {
+        if (gruppo[i] & 0x80)
+            m |= (Maschera)1 << i;
+    }
+    return m;
+#endif
+}
+/**
+ * @brief Metodo che restituisce l'indice del bit a 1 meno significativo.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param m maschera non nulla.
+ * @return indice del primo bit a 1.
+ */
+template <class K, class E, class H>
+int SwissHash<K,E,H>::primoBit(Maschera m) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(m);
+#else
+    int i = 0;
+    while ((m & 1) == 0) {
+        m >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+/**
+ * @brief Metodo che alloca gruppi di bucket vuoti.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param gruppi numero di gruppi da allocare.
+ */
+template <class K, class E, class H>
+void SwissHash<K,E,H>::allocaBuckets(int gruppi) {
+    buckets = static_cast<Couple<K,E>*>(::operator new(sizeof(Couple<K,E>) * gruppi * GRUPPO));
+    stato = new unsigned char[gruppi * GRUPPO];
+    for (int i = 0; i < gruppi * GRUPPO; i++)
+        stato[i] = VUOTO;
+    numGruppi = gruppi;
+}
+/**
+ * @brief Metodo che distrugge le coppie presenti e rilascia i bucket.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ */
+template <class K, class E, class H>
+void SwissHash<K,E,H>::liberaBuckets() {
+    for (int i = 0; i < numGruppi * GRUPPO; i++) {
+        if ((stato[i] & 0x80) == 0)
+            buckets[i].~Couple<K,E>();
+    }
+    ::operator delete(buckets);
+    delete[] stato;
+}
+/**
+ * @brief Metodo che copia i bucket di h, nelle stesse posizioni e con lo stesso stato.
+ * I membri vengono sovrascritti solo dopo che la copia è riuscita: la tabella
+ * precedente, se esiste, resta al chiamante. Se la copia fallisce, le coppie già
+ * copiate vengono distrutte e la memoria rilasciata.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param h dizionario da copiare.
+ */
+template <class K, class E, class H>
+void SwissHash<K,E,H>::copiaBuckets(const SwissHash<K,E,H>& h) {
+    int dim = h.numGruppi * GRUPPO;
+    Couple<K,E>* coppie = static_cast<Couple<K,E>*>(::operator new(sizeof(Couple<K,E>) * dim));
+    unsigned char* stati = nullptr;
+    int i = 0;
+    try {
+        stati = new unsigned char[dim];
+        for (; i < dim; i++) {
+            if ((h.stato[i] & 0x80) == 0)
+                new (&coppie[i]) Couple<K,E>(h.buckets[i]);
+        }
+    } catch (...) {
+        for (int j = 0; j < i; j++) {
+            if ((h.stato[j] & 0x80) == 0)
+                coppie[j].~Couple<K,E>();
+        }
+        delete[] stati;
+        ::operator delete(coppie);
+        throw;
+    }
+    std::copy(h.stato, h.stato + dim, stati);
+    buckets = coppie;
+    stato = stati;
+    numGruppi = h.numGruppi;
+    bucketsUsed = h.bucketsUsed;
+    bucketsDeleted = h.bucketsDeleted;
+}
+/**
+ * @brief Metodo che ricostruisce la tabella con il numero di gruppi indicato.
+ * Le coppie vengono spostate, senza copiarle; i bucket cancellati non vengono
+ * riportati nella nuova tabella.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param gruppi nuovo numero di gruppi, potenza di 2.
+ */
+template <class K, class E, class H>
+void SwissHash<K,E,H>::changeGruppi(int gruppi) {
+    Couple<K,E>* oldBuckets = buckets;
+    unsigned char* oldStato = stato;
+    int oldDim = numGruppi * GRUPPO;
+    allocaBuckets(gruppi);
+
+    for (int i = 0; i < oldDim; i++) {
+        if ((oldStato[i] & 0x80) == 0) {
+            int j = cercaLibero(calcHash(oldBuckets[i].getKey()));
+            new (&buckets[j]) Couple<K,E>(std::move(oldBuckets[i]));
+            stato[j] = oldStato[i];
+            oldBuckets[i].~Couple<K,E>();
+        }
+    }
+
+    ::operator delete(oldBuckets);
+    delete[] oldStato;
+    bucketsDeleted = 0;
+}
+/**
+ * @brief Metodo che inserisce una coppia costruita con gli argomenti args, se la
+ * chiave key non è già presente. La coppia viene costruita direttamente nel bucket
+ * trovato, dopo l'ultimo utilizzo di key.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave della coppia da inserire.
+ * @param args argomenti del costruttore di Couple<K, E>.
+ * @return indice del bucket contenente la chiave key e true se la coppia è stata
+ * inserita, false se la chiave era già presente.
+ */
+template <class K, class E, class H>
+template <class... Args>
+std::pair<int, bool> SwissHash<K,E,H>::inserisciSeAssente(const Key& key, Args&&... args) {
+    size_t h = calcHash(key);
+    int i = cercaSlot(key, h);
+    if (i != -1)
+        return {i, false};
+
+    i = cercaLibero(h);
+    // Se la coppia non riutilizza un bucket cancellato e il numero di bucket occupati
+    // o cancellati è maggiore o uguale all'87.5% del numero di bucket
+    if (stato[i] == VUOTO && (double)(bucketsUsed + bucketsDeleted + 1) > (double)numGruppi * GRUPPO * 0.875) {
+        // Se i bucket cancellati sono la maggior parte la tabella viene solo ricostruita
+        if ((double)bucketsUsed < (double)numGruppi * GRUPPO * 0.4375)
+            changeGruppi(numGruppi);
+        else
+            changeGruppi(numGruppi * 2);
+        i = cercaLibero(h);
+    }
+
+    if (stato[i] == CANCELLATO)
+        bucketsDeleted--;
+    new (&buckets[i]) Couple<K,E>(std::forward<Args>(args)...);
+    stato[i] = static_cast<unsigned char>(h & 0x7F);
+    bucketsUsed++;
+    return {i, true};
+}
+/**
+ * @brief Metodo che calcola l'hash di una chiave.
+ * I 7 bit meno significativi sono l'impronta memorizzata nel byte di controllo,
+ * i restanti selezionano il gruppo di partenza: entrambi richiedono bit bassi ben
+ * distribuiti. Hash<K> e HashSeeded<K> li garantiscono già e il loro risultato è
+ * usato così com'è; l'hash di una funzione qualsiasi, ad esempio l'identità di
+ * std::hash sugli interi, viene rimescolato con HashBase::mescola.
+ * Hash<K> non ha seme: con chiavi scelte da terzi va usata HashSeeded<K>.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave.
+ * @return hash della chiave.
+ */
+template <class K, class E, class H>
+size_t SwissHash<K,E,H>::calcHash(const Key& key) const {
+    if constexpr (std::is_same<H, Hash<K>>::value || std::is_same<H, HashSeeded<K>>::value)
+        return size_t(hash(key));
+    else
+        return size_t(HashBase::mescola(uint64_t(hash(key))));
+}
+/**
+ * @brief Metodo che individua il bucket contenente la chiave key.
+ * Per ogni gruppo della sequenza di sondaggio confronta l'impronta della chiave con
+ * l'intero gruppo e verifica le sole chiavi con impronta uguale; si interrompe al
+ * primo gruppo che contiene un bucket vuoto.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param key chiave da cercare.
+ * @param h hash della chiave.
+ * @return indice del bucket contenente key, -1 se la chiave non è presente.
+ */
+template <class K, class E, class H>
+int SwissHash<K,E,H>::cercaSlot(const Key& key, size_t h) const {
+    unsigned char impronta = static_cast<unsigned char>(h & 0x7F);
+    int g = static_cast<int>((h >> 7) & (numGruppi - 1));
+    for (int n = 0; n < numGruppi; n++) {
+        const unsigned char* gruppo = stato + g * GRUPPO;
+        for (Maschera m = corrisponde(gruppo, impronta); m != 0; m &= m - 1) {
+            int i = g * GRUPPO + primoBit(m);
+            if (buckets[i].getKey() == key)
+                return i;
+        }
+        if (corrisponde(gruppo, VUOTO) != 0)
+            return -1;
+        g = (g + n + 1) & (numGruppi - 1);    // sondaggio triangolare tra i gruppi
+    }
+    return -1;
+}
+/**
+ * @brief Metodo che individua il primo bucket vuoto o cancellato della sequenza di
+ * sondaggio di un hash.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param h hash della chiave.
+ * @return indice del primo bucket libero.
+ */
+template <class K, class E, class H>
+int SwissHash<K,E,H>::cercaLibero(size_t h) const {
+    int g = static_cast<int>((h >> 7) & (numGruppi - 1));
+    for (int n = 0; n < numGruppi; n++) {
+        Maschera m = liberi(stato + g * GRUPPO);
+        if (m != 0)
+            return g * GRUPPO + primoBit(m);
+        g = (g + n + 1) & (numGruppi - 1);
+    }
+    throw std::runtime_error("Error: impossibile inserire la coppia");
+}
+/**
+ * @brief Metodo che individua il primo bucket occupato a partire dalla posizione i.
+ * @tparam K tipo della chiave.
+ * @tparam E tipo dell'elemento.
+ * @param i posizione da cui iniziare la ricerca.
+ * @return posizione del primo bucket occupato, numGruppi * GRUPPO se non ce ne sono altri.
+ */
+template <class K, class E, class H>
+int SwissHash<K,E,H>::prossimo(int i) const {
+    while (i < numGruppi * GRUPPO && (stato[i] & 0x80) != 0)
+        i++;
+    return i;
+}
+
+#endif //DICTIONARY_SWISSHASH_H
@@ -0,0 +1,388 @@
+#include "ClosedHash.h"
+#include "SwissHash.h"
+#include "OpenHash.h"
+#include "ConcurrentHash.h"
+#include "LockFreeHash.h"
+#include "SmallHash.h"
+#include "CowHash.h"
+#include "BTree.h"
+#include "ArtTree.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+using namespace std;
+
+/*
+ * Benchmark dei dizionari: per ogni struttura, distribuzione delle chiavi e numero
+ * di coppie stampa su stdout righe CSV
+ *     struttura,distribuzione,n,misura,valore,unita
+ * con i tempi in ns per operazione di inserimento, ricerca di chiavi presenti e
+ * assenti, cancellazione, visita e copia, e la memoria in byte per coppia.
+ *
+ * Uso: Benchmark [n_massimo] [struttura] [distribuzione]
+ * n va da 1e3 a n_massimo (1e6 se omesso, fino a 1e8) per potenze di 10; struttura e
+ * distribuzione, se presenti, limitano le misure a quelle con il nome indicato.
+ * Una struttura che supera 10 us per operazione su una distribuzione non viene misurata
+ * su quella distribuzione per gli n successivi.
+ * I numeri hanno senso solo con una build ottimizzata (-DCMAKE_BUILD_TYPE=Release).
+ */
+
+// Byte allocati con new e non ancora rilasciati, per la misura della memoria
+static atomic<size_t> byteVivi(0);
+static const size_t INTESTAZIONE = 16;
+
+// Gli operatori sostitutivi non devono essere espansi nei chiamanti: il compilatore
+// vedrebbe free() su un puntatore ottenuto da new e un accesso prima dell'inizio del blocco
+#if defined(__GNUC__)
+#define NON_IN_LINEA __attribute__((noinline))
+#else
+#define NON_IN_LINEA
+#endif
+
+NON_IN_LINEA void* operator new(size_t dim) {
+    void* p = malloc(dim + INTESTAZIONE);
+    if (p == nullptr)
+        throw bad_alloc();
+    *static_cast<size_t*>(p) = dim;
+    byteVivi.fetch_add(dim, memory_order_relaxed);
+    return static_cast<char*>(p) + INTESTAZIONE;
+}
+NON_IN_LINEA void operator delete(void* p) noexcept {
+    if (p == nullptr)
+        return;
+    char* base = static_cast<char*>(p) - INTESTAZIONE;
+    byteVivi.fetch_sub(*reinterpret_cast<size_t*>(base), memory_order_relaxed);
+    free(base);
+}
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+NON_IN_LINEA void* operator new(size_t dim, align_val_t allineamento) {
+    size_t a = size_t(allineamento) < INTESTAZIONE ? INTESTAZIONE : size_t(allineamento);
+    void* p = aligned_alloc(a, (dim + a + a - 1) / a * a);
+    if (p == nullptr)
+        throw bad_alloc();
+    char* q = static_cast<char*>(p) + a;
+    *reinterpret_cast<size_t*>(q - sizeof(size_t)) = dim;
+    byteVivi.fetch_add(dim, memory_order_relaxed);
+    return q;
+}
+NON_IN_LINEA void operator delete(void* p, align_val_t allineamento) noexcept {
+    if (p == nullptr)
+        return;
+    size_t a = size_t(allineamento) < INTESTAZIONE ? INTESTAZIONE : size_t(allineamento);
+    char* q = static_cast<char*>(p);
+    byteVivi.fetch_sub(*reinterpret_cast<size_t*>(q - sizeof(size_t)), memory_order_relaxed);
+    free(q - a);
+}
+void operator delete(void* p, size_t, align_val_t allineamento) noexcept {
+    operator delete(p, allineamento);
+}
+
+/**
+ * @brief Inverso di HashBase::mescola: restituisce la chiave intera il cui hash è h.
+ * @param h hash desiderato.
+ * @return chiave con hash h.
+ */
+uint64_t smescola(uint64_t h) {
+    // Inverso moltiplicativo modulo 2^64 con il metodo di Newton
+    auto inverso = [](uint64_t a) {
+        uint64_t x = a;
+        for (int i = 0; i < 5; i++)
+            x *= 2 - a * x;
+        return x;
+    };
+    h ^= h >> 33;
+    h *= inverso(0xc4ceb9fe1a85ec53ULL);
+    h ^= h >> 33;
+    h *= inverso(0xff51afd7ed558ccdULL);
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * @brief Generatore di indici in [0, n) con distribuzione di Zipf di parametro theta
+ * (metodo di Gray et al., lo stesso di YCSB): l'indice 0 è il più frequente.
+ */
+class Zipf {
+public:
+    Zipf(uint64_t n, double theta) : n(n), theta(theta) {
+        double zeta2 = 0;
+        zetan = 0;
+        for (uint64_t i = 1; i <= n; i++) {
+            zetan += 1.0 / pow(double(i), theta);
+            if (i == 2)
+                zeta2 = zetan;
+        }
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - pow(2.0 / double(n), 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+    template <class G>
+    uint64_t operator()(G& g) {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(g);
+        double uz = u * zetan;
+        if (uz < 1.0)
+            return 0;
+        if (uz < 1.0 + pow(0.5, theta))
+            return 1;
+        uint64_t i = uint64_t(double(n) * pow(eta * u - eta + 1.0, alpha));
+        return i < n ? i : n - 1;
+    }
+
+private:
+    uint64_t n;
+    double theta, zetan, alpha, eta;
+};
+
+/**
+ * @brief Chiavi e sequenze di accesso di una distribuzione.
+ * - sequenziale: chiavi 0..n-1, accessi in ordine;
+ * - uniforme: chiavi casuali a 64 bit, accessi in ordine casuale;
+ * - zipf: chiavi casuali, accessi con distribuzione di Zipf (theta 0.99) sulle chiavi;
+ * - avversaria: chiavi i cui hash Hash<uint64_t> hanno i 32 bit bassi tutti uguali,
+ *   accessi in ordine casuale.
+ * Le chiavi assenti sono generate allo stesso modo, disgiunte da quelle presenti.
+ */
+struct Carico {
+    vector<uint64_t> presenti;
+    vector<uint64_t> accessi;
+    vector<uint64_t> assenti;
+    vector<uint64_t> cancellazioni;
+};
+
+Carico generaCarico(const string& distribuzione, size_t n) {
+    mt19937_64 g(12345);
+    Carico c;
+    c.presenti.resize(n);
+    c.assenti.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        if (distribuzione == "sequenziale") {
+            c.presenti[i] = i;
+            c.assenti[i] = n + i;
+        } else if (distribuzione == "avversaria") {
+            c.presenti[i] = smescola(uint64_t(i) << 32);
+            c.assenti[i] = smescola(uint64_t(n + i) << 32);
+        } else {
+            // Il bit basso separa le chiavi presenti dalle assenti
+            c.presenti[i] = g() & ~uint64_t(1);
+            c.assenti[i] = g() | 1;
+        }
+    }
+    if (distribuzione != "sequenziale") {
+        // Chiavi casuali ripetute: improbabili, ma inserisci() non le ammette
+        vector<uint64_t> ordinate(c.presenti);
+        sort(ordinate.begin(), ordinate.end());
+        if (adjacent_find(ordinate.begin(), ordinate.end()) != ordinate.end()) {
+            ordinate.erase(unique(ordinate.begin(), ordinate.end()), ordinate.end());
+            c.presenti = ordinate;
+            shuffle(c.presenti.begin(), c.presenti.end(), g);
+        }
+    }
+    c.accessi = c.presenti;
+    if (distribuzione == "zipf") {
+        Zipf z(c.presenti.size(), 0.99);
+        for (uint64_t& a : c.accessi)
+            a = c.presenti[z(g)];
+    } else if (distribuzione != "sequenziale") {
+        shuffle(c.accessi.begin(), c.accessi.end(), g);
+    }
+    c.cancellazioni = c.presenti;
+    if (distribuzione != "sequenziale")
+        shuffle(c.cancellazioni.begin(), c.cancellazioni.end(), g);
+    return c;
+}
+
+/**
+ * @brief Conversione delle chiavi intere generate nel tipo di chiave del dizionario.
+ * Le chiavi stringa imitano URL con lunghi prefissi comuni.
+ */
+template <class K>
+K chiave(uint64_t k) {
+    return K(k);
+}
+template <>
+string chiave<string>(uint64_t k) {
+    return "https://www.esempio.it/catalogo/reparto" + to_string(k % 64) + "/articolo/" + to_string(k);
+}
+
+// Rilevamento delle visite disponibili: iteratori, perOgni() o, in mancanza, values()
+template <class D, class = void>
+struct HaIteratori : false_type {};
+template <class D>
+struct HaIteratori<D, void_t<decltype(declval<const D&>().begin())>> : true_type {};
+template <class D, class = void>
+struct HaPerOgni : false_type {};
+template <class D>
+struct HaPerOgni<D, void_t<decltype(&D::template perOgni<void (*)(const string&, const uint64_t&)>)>> : true_type {};
+
+template <class D>
+uint64_t visita(const D& d) {
+    uint64_t somma = 0;
+    if constexpr (HaIteratori<D>::value) {
+        for (const auto& c : d)
+            somma += uint64_t(c.getElement());
+    } else if constexpr (HaPerOgni<D>::value) {
+        d.perOgni([&somma](const string&, const uint64_t& e) {somma += e;});
+    } else {
+        VectorList<uint64_t> valori = d.values();
+        for (int p = valori.primoLista(); !valori.fineLista(p); p = valori.succLista(p))
+            somma += valori.leggiLista(p);
+    }
+    return somma;
+}
+
+static volatile uint64_t pozzo;     // impedisce al compilatore di eliminare le misure
+
+/**
+ * @brief Stampa una riga CSV.
+ */
+void riga(const string& struttura, const string& distribuzione, size_t n, const string& misura,
+          double valore, const string& unita) {
+    printf("%s,%s,%zu,%s,%.2f,%s\n", struttura.c_str(), distribuzione.c_str(), n, misura.c_str(),
+           valore, unita.c_str());
+    fflush(stdout);
+}
+
+/**
+ * @brief Misura una struttura su un carico: ogni operazione è ripetuta finché non
+ * coinvolge almeno un milione di coppie, così che anche le misure su n piccolo
+ * durino abbastanza.
+ * @tparam D tipo del dizionario, costruibile senza argomenti.
+ * @return il tempo per operazione più alto tra quelli misurati, in ns.
+ */
+template <class D>
+double misura(const string& struttura, const string& distribuzione, const Carico& carico) {
+    typedef typename D::Key K;
+    typedef chrono::steady_clock Orologio;
+    size_t n = carico.presenti.size();
+    size_t ripetizioni = max<size_t>(1, 1000000 / n);
+    auto nsPerOperazione = [n, ripetizioni](Orologio::time_point inizio) {
+        return chrono::duration<double, nano>(Orologio::now() - inizio).count() / double(n * ripetizioni);
+    };
+
+    vector<K> presenti, accessi, assenti, cancellazioni;
+    for (size_t i = 0; i < n; i++) {
+        presenti.push_back(chiave<K>(carico.presenti[i]));
+        accessi.push_back(chiave<K>(carico.accessi[i]));
+        assenti.push_back(chiave<K>(carico.assenti[i]));
+        cancellazioni.push_back(chiave<K>(carico.cancellazioni[i]));
+    }
+
+    double peggiore = 0;
+    auto tempo = [&](const string& nome, double ns, const string& unita) {
+        riga(struttura, distribuzione, n, nome, ns, unita);
+        peggiore = max(peggiore, ns);
+    };
+
+    double tInserimento = 0, tCancellazione = 0;
+    for (size_t r = 0; r < ripetizioni; r++) {
+        // La memoria comprende quella allocata dal costruttore
+        size_t prima = byteVivi.load();
+        unique_ptr<D> dizionario = make_unique<D>();
+        D& d = *dizionario;
+        auto inizio = Orologio::now();
+        for (size_t i = 0; i < n; i++)
+            d.inserisci(Couple<K, uint64_t>(presenti[i], i));
+        tInserimento += chrono::duration<double, nano>(Orologio::now() - inizio).count();
+        if (r == 0)
+            riga(struttura, distribuzione, n, "memoria", double(byteVivi.load() - prima) / double(n), "byte/coppia");
+
+        if (r == ripetizioni - 1) {
+            uint64_t somma = 0;
+            inizio = Orologio::now();
+            for (size_t k = 0; k < ripetizioni; k++) {
+                for (size_t i = 0; i < n; i++)
+                    somma += d.recupera(accessi[i]);
+            }
+            tempo("ricerca_presente", nsPerOperazione(inizio), "ns/op");
+
+            inizio = Orologio::now();
+            for (size_t k = 0; k < ripetizioni; k++) {
+                for (size_t i = 0; i < n; i++)
+                    somma += d.appartiene(assenti[i]);
+            }
+            tempo("ricerca_assente", nsPerOperazione(inizio), "ns/op");
+
+            inizio = Orologio::now();
+            for (size_t k = 0; k < ripetizioni; k++)
+                somma += visita(d);
+            tempo("visita", nsPerOperazione(inizio), "ns/coppia");
+
+            if constexpr (is_copy_constructible<D>::value) {
+                inizio = Orologio::now();
+                for (size_t k = 0; k < ripetizioni; k++) {
+                    D copia(d);
+                    somma += copia.lunghezza();
+                }
+                tempo("copia", nsPerOperazione(inizio), "ns/coppia");
+            }
+            pozzo = somma;
+        }
+
+        inizio = Orologio::now();
+        for (size_t i = 0; i < n; i++)
+            d.cancella(cancellazioni[i]);
+        tCancellazione += chrono::duration<double, nano>(Orologio::now() - inizio).count();
+    }
+    tempo("inserimento", tInserimento / double(n * ripetizioni), "ns/op");
+    tempo("cancellazione", tCancellazione / double(n * ripetizioni), "ns/op");
+    return peggiore;
+}
+
+int main(int argc, char* argv[]) {
+    size_t massimo = argc > 1 ? size_t(atof(argv[1])) : 1000000;
+    string soloStruttura = argc > 2 ? argv[2] : "";
+    string soloDistribuzione = argc > 3 ? argv[3] : "";
+    const char* distribuzioni[] = {"sequenziale", "uniforme", "zipf", "avversaria"};
+
+    // Una struttura che degenera, come una tabella hash su chiavi avversarie, costa
+    // O(n) per operazione: con n dieci volte più grande la misura durerebbe cento volte tanto
+    const double SOGLIA_DEGENERE = 10000;
+    set<string> degeneri;
+
+    printf("struttura,distribuzione,n,misura,valore,unita\n");
+    for (size_t n = 1000; n <= massimo; n *= 10) {
+        for (const char* distribuzione : distribuzioni) {
+            if (!soloDistribuzione.empty() && soloDistribuzione != distribuzione)
+                continue;
+            Carico carico = generaCarico(distribuzione, n);
+            auto esegui = [&](const string& struttura, auto* tipo) {
+                typedef remove_pointer_t<decltype(tipo)> D;
+                string nome = struttura + "/" + distribuzione;
+                if ((!soloStruttura.empty() && soloStruttura != struttura) || degeneri.count(nome) != 0)
+                    return;
+                if (misura<D>(struttura, distribuzione, carico) > SOGLIA_DEGENERE) {
+                    degeneri.insert(nome);
+                    cerr << nome << ": oltre " << SOGLIA_DEGENERE << " ns/op con n = " << n
+                         << ", non misurata per n maggiori." << endl;
+                }
+            };
+            esegui("ClosedHash", (ClosedHash<uint64_t, uint64_t>*)nullptr);
+            esegui("SwissHash", (SwissHash<uint64_t, uint64_t>*)nullptr);
+            esegui("OpenHash", (OpenHash<uint64_t, uint64_t>*)nullptr);
+            esegui("ConcurrentHash", (ConcurrentHash<uint64_t, uint64_t>*)nullptr);
+            esegui("LockFreeHash", (LockFreeHash<uint64_t, uint64_t>*)nullptr);
+            esegui("SmallHash", (SmallHash<uint64_t, uint64_t>*)nullptr);
+            esegui("CowHash", (CowHash<uint64_t, uint64_t>*)nullptr);
+            esegui("BTree", (BTree<uint64_t, uint64_t>*)nullptr);
+            // Chiavi stringa simili a URL
+            esegui("ClosedHash<string>", (ClosedHash<string, uint64_t>*)nullptr);
+            esegui("SwissHash<string>", (SwissHash<string, uint64_t>*)nullptr);
+            esegui("BTree<string>", (BTree<string, uint64_t>*)nullptr);
+            esegui("ArtTree", (ArtTree<uint64_t>*)nullptr);
+        }
+    }
+    return 0;
+}
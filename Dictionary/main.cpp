@@ -1,7 +1,23 @@
 #include <iostream>
 #include "ClosedHash.h"
+#include "Arena.h"
+#include "SwissHash.h"
+#include "OpenHash.h"
+#include "ConcurrentHash.h"
+#include "LockFreeHash.h"
+#include "MappedHash.h"
+#include "FrozenHash.h"
+#include "SmallHash.h"
+#include "CowHash.h"
+#include "BTree.h"
+#include "ArtTree.h"
 #include "../List/VectorList.h"
+#include <atomic>
+#include <cstdio>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 
 using namespace std;
@@ -123,6 +139,29 @@ void testClosedHash() {
         cout << "ERRORE: La chiave 2 non e' stata rimossa correttamente dal dizionario." << endl;
     }
 
+    // Verifica la ricerca senza eccezioni
+    string found;
+    if (dictionary.find(2) == nullptr && !dictionary.tryGet(2, found)) {
+        cout << "La ricerca della chiave 2 non la trova e non solleva eccezioni." << endl;
+    } else {
+        cout << "ERRORE: La ricerca della chiave 2 la trova dopo la rimozione." << endl;
+    }
+
+    if (dictionary.tryGet(3, found) && found == "Three" && dictionary.find(3)->getElement() == "Three") {
+        cout << "La ricerca della chiave 3 dopo la rimozione della chiave 2 la trova." << endl;
+    } else {
+        cout << "ERRORE: La ricerca della chiave 3 dopo la rimozione della chiave 2 non la trova." << endl;
+    }
+
+    // Verifica la riorganizzazione dei bucket cancellati
+    dictionary.riorganizza();
+
+    if (dictionary.cancellati() == 0 && dictionary.appartiene(3) && dictionary.lunghezza() == 2) {
+        cout << "La riorganizzazione ha eliminato i bucket cancellati mantenendo le coppie." << endl;
+    } else {
+        cout << "ERRORE: La riorganizzazione non ha eliminato correttamente i bucket cancellati." << endl;
+    }
+
     // Verifica che il dizionario sia correttamente ripulito
     dictionary.clear();
 
@@ -139,7 +178,801 @@ void testClosedHash() {
     }
 }
 
+void testClosedHashRobinHood() {
+    ClosedHash<int, string> dictionary(20, Sondaggio::ROBIN_HOOD);
+
+    // Inserimento di 100 coppie, con collisioni e raddoppi della tabella
+    for (int i = 0; i < 100; i++) {
+        Couple<int, string> couple(i * 20, to_string(i));
+        dictionary.inserisci(couple);
+    }
+
+    // Rimozione delle chiavi pari
+    for (int i = 0; i < 100; i += 2)
+        dictionary.cancella(i * 20);
+
+    bool corretto = dictionary.lunghezza() == 50 && dictionary.cancellati() == 0;
+    for (int i = 0; i < 100; i++) {
+        if (dictionary.appartiene(i * 20) != (i % 2 == 1))
+            corretto = false;
+    }
+
+    if (corretto) {
+        cout << "Robin Hood: inserimenti e cancellazioni con compattamento corretti." << endl;
+    } else {
+        cout << "ERRORE: Robin Hood: inserimenti o cancellazioni errati." << endl;
+    }
+
+    VectorList<int> istogramma = dictionary.istogrammaSondaggi();
+    int totale = 0;
+    for (int p = 1; p <= istogramma.lunghezza(); p++)
+        totale += istogramma.leggiLista(p);
+
+    cout << "Robin Hood: sondaggio massimo " << dictionary.sondaggioMassimo()
+         << ", medio " << dictionary.sondaggioMedio() << endl;
+    if (totale == dictionary.lunghezza() && istogramma.lunghezza() == dictionary.sondaggioMassimo() + 1) {
+        cout << "Robin Hood: l'istogramma dei sondaggi conta tutte le coppie." << endl;
+    } else {
+        cout << "ERRORE: Robin Hood: l'istogramma dei sondaggi e' errato." << endl;
+    }
+}
+
+void testHash() {
+    // Stringhe uguali costruite separatamente devono avere lo stesso hash, per ogni lunghezza
+    Hash<string> hash;
+    bool coerente = true;
+    string s;
+    for (int len = 0; len < 100; len++) {
+        string copia(s.c_str(), s.size());
+        if (hash(s) != hash(copia) || (len > 0 && hash(s) == hash(s.substr(0, len - 1))))
+            coerente = false;
+        s += (char)('a' + len % 26);
+    }
+
+    if (coerente) {
+        cout << "Hash<string> e' coerente per stringhe da 0 a 99 caratteri." << endl;
+    } else {
+        cout << "ERRORE: Hash<string> non e' coerente." << endl;
+    }
+
+    // Dizionario con funzione hash con seme
+    ClosedHash<string, int, HashSeeded<string>> dictionary;
+    for (int i = 0; i < 100; i++) {
+        Couple<string, int> couple("chiave" + to_string(i), i);
+        dictionary.inserisci(couple);
+    }
+
+    if (dictionary.lunghezza() == 100 && dictionary.recupera("chiave42") == 42) {
+        cout << "ClosedHash con HashSeeded<string> funziona correttamente." << endl;
+    } else {
+        cout << "ERRORE: ClosedHash con HashSeeded<string> non funziona correttamente." << endl;
+    }
+}
+
+void testEmplace() {
+    ClosedHash<string, string> dictionary;
+
+    // Inserimento per spostamento: la coppia originale resta vuota
+    Couple<string, string> couple("chiave", string(100, 'x'));
+    dictionary.inserisci(std::move(couple));
+
+    auto r1 = dictionary.try_emplace("altra", 3, 'y');
+    auto r2 = dictionary.try_emplace("chiave", 3, 'z');
+    if (couple.getElement().empty() && r1.second && r1.first->getElement() == "yyy"
+        && !r2.second && r2.first->getElement() == string(100, 'x')) {
+        cout << "try_emplace costruisce l'elemento solo se la chiave non e' presente." << endl;
+    } else {
+        cout << "ERRORE: try_emplace non funziona correttamente." << endl;
+    }
+
+    auto r3 = dictionary.insert_or_assign("chiave", "nuovo");
+    auto r4 = dictionary.emplace("terza", "tre");
+    if (!r3.second && dictionary.recupera("chiave") == "nuovo" && r4.second && dictionary.lunghezza() == 3) {
+        cout << "insert_or_assign ed emplace funzionano correttamente." << endl;
+    } else {
+        cout << "ERRORE: insert_or_assign o emplace non funzionano correttamente." << endl;
+    }
+}
+
+void testCaricamento() {
+    // Costruzione da un intervallo: la tabella viene dimensionata una sola volta
+    vector<Couple<int, string>> coppie;
+    for (int i = 0; i < 1000; i++)
+        coppie.push_back(Couple<int, string>(i * 7, to_string(i)));
+    ClosedHash<int, string> dictionary(make_move_iterator(coppie.begin()), make_move_iterator(coppie.end()));
+
+    bool corretto = dictionary.lunghezza() == 1000;
+    for (int i = 0; i < 1000; i++) {
+        if (dictionary.recupera(i * 7) != to_string(i))
+            corretto = false;
+    }
+
+    if (corretto) {
+        cout << "Costruzione da intervallo di 1000 coppie corretta." << endl;
+    } else {
+        cout << "ERRORE: Costruzione da intervallo errata." << endl;
+    }
+
+    // Dopo reserve gli inserimenti non spostano le coppie già presenti
+    ClosedHash<int, string> riservato;
+    riservato.reserve(1000);
+    riservato.try_emplace(0, "0");
+    const Couple<int, string>* prima = riservato.find(0);
+    for (int i = 1; i < 1000; i++)
+        riservato.try_emplace(i, to_string(i));
+    bool stabile = riservato.find(0) == prima;
+
+    if (stabile && riservato.lunghezza() == 1000 && riservato.recupera(999) == "999") {
+        cout << "reserve evita le ricostruzioni della tabella." << endl;
+    } else {
+        cout << "ERRORE: reserve non evita le ricostruzioni della tabella." << endl;
+    }
+}
+
+void testIncrementale() {
+    // Ridimensionamento incrementale: le coppie restano raggiungibili durante il trasferimento
+    Sondaggio politiche[] = {Sondaggio::LINEARE, Sondaggio::ROBIN_HOOD};
+    for (Sondaggio politica : politiche) {
+        ClosedHash<int, string> dictionary(8, politica, Ridimensionamento::INCREMENTALE);
+        bool osservato = false;
+        bool corretto = true;
+        for (int i = 0; i < 5000; i++) {
+            dictionary.try_emplace(i, to_string(i));
+            if (dictionary.trasferimentoInCorso()) {
+                osservato = true;
+                if (!dictionary.appartiene(i / 2) || dictionary.lunghezza() != i + 1)
+                    corretto = false;
+            }
+        }
+        for (int i = 0; i < 5000; i += 2)
+            dictionary.cancella(i);
+        for (int i = 0; i < 5000; i++) {
+            if (dictionary.appartiene(i) != (i % 2 == 1))
+                corretto = false;
+        }
+
+        string nome = politica == Sondaggio::LINEARE ? "lineare" : "Robin Hood";
+        if (osservato && corretto && dictionary.lunghezza() == 2500) {
+            cout << "Ridimensionamento incrementale (" << nome << ") corretto." << endl;
+        } else {
+            cout << "ERRORE: Ridimensionamento incrementale (" << nome << ") errato." << endl;
+        }
+    }
+}
+
+template <class D>
+bool visitaTutte(D& dictionary, int n) {
+    // Ogni chiave in [0, n) deve essere visitata una sola volta; l'elemento viene modificato sul posto
+    vector<int> visite(n, 0);
+    for (Couple<int, string>& c : dictionary.entries()) {
+        visite[c.getKey()]++;
+        c.getElement() += "!";
+    }
+    const D& costante = dictionary;
+    int contate = 0;
+    for (typename D::const_iterator it = costante.begin(); it != costante.end(); ++it) {
+        if (it->getElement() != to_string(it->getKey()) + "!")
+            return false;
+        contate++;
+    }
+    for (int v : visite) {
+        if (v != 1)
+            return false;
+    }
+    return contate == n;
+}
+
+void testIteratori() {
+    ClosedHash<int, string> closed(8, Sondaggio::ROBIN_HOOD, Ridimensionamento::INCREMENTALE);
+    SwissHash<int, string> swiss;
+    OpenHash<int, string> open;
+    int n = 0;
+    // Si ferma durante un trasferimento, così che l'iterazione attraversi entrambe le tabelle
+    while (n < 100 || !closed.trasferimentoInCorso()) {
+        closed.try_emplace(n, to_string(n));
+        swiss.try_emplace(n, to_string(n));
+        open.try_emplace(n, to_string(n));
+        n++;
+    }
+
+    if (visitaTutte(closed, n) && visitaTutte(swiss, n) && visitaTutte(open, n)) {
+        cout << "Iterazione sulle coppie corretta." << endl;
+    } else {
+        cout << "ERRORE: Iterazione sulle coppie errata." << endl;
+    }
+}
+
+void testTrasparente() {
+    // Ricerche con string_view e const char* senza costruire una string
+    ClosedHash<string, int> dictionary;
+    for (int i = 0; i < 100; i++)
+        dictionary.try_emplace("chiave" + to_string(i), i);
+
+    const char buffer[] = "GET chiave42 chiave99";
+    string_view richiesta(buffer);
+    string_view prima = richiesta.substr(4, 8);
+    string_view seconda = richiesta.substr(13, 8);
+
+    int valore = -1;
+    bool corretto = dictionary.recupera(prima) == 42 && dictionary.appartiene("chiave7")
+                    && !dictionary.appartiene(richiesta.substr(0, 3))
+                    && dictionary.tryGet(seconda, valore) && valore == 99
+                    && dictionary.find(prima)->getKey() == "chiave42";
+    dictionary.cancella(seconda);
+    corretto = corretto && !dictionary.appartiene(string("chiave99")) && dictionary.lunghezza() == 99;
+
+    if (corretto) {
+        cout << "Ricerca con chiavi string_view e const char* corretta." << endl;
+    } else {
+        cout << "ERRORE: Ricerca con chiavi string_view e const char* errata." << endl;
+    }
+}
+
+void testRecuperaMolti() {
+    // Ricerca a blocchi: chiavi presenti e assenti, anche durante un trasferimento incrementale
+    ClosedHash<int, string> dictionary(8, Sondaggio::LINEARE, Ridimensionamento::INCREMENTALE);
+    for (int i = 0; i < 1000; i += 2)
+        dictionary.try_emplace(i, to_string(i));
+
+    const int n = 100;
+    int chiavi[n];
+    for (int i = 0; i < n; i++)
+        chiavi[i] = i * 10 + 1 - i % 2;    // una chiave presente e una assente, alternate
+    string risultati[n];
+    uint64_t trovati[(n + 63) / 64];
+    int presenti = dictionary.recuperaMolti(chiavi, n, risultati, trovati);
+
+    bool corretto = presenti == n / 2;
+    for (int i = 0; i < n; i++) {
+        bool trovato = (trovati[i / 64] >> (i % 64)) & 1;
+        if (trovato != (i % 2 == 1) || (trovato && risultati[i] != to_string(chiavi[i])))
+            corretto = false;
+    }
+
+    if (corretto) {
+        cout << "recuperaMolti corretto." << endl;
+    } else {
+        cout << "ERRORE: recuperaMolti errato." << endl;
+    }
+}
+
+void testStatistiche() {
+    ClosedHash<int, string> dictionary(8, Sondaggio::ROBIN_HOOD);
+    for (int i = 0; i < 1000; i++)
+        dictionary.try_emplace(i, to_string(i));
+    for (int i = 0; i < 2000; i++)
+        dictionary.appartiene(i);
+
+    StatisticheHash s = dictionary.statistiche();
+    int somma = 0;
+    for (int n : s.istogramma)
+        somma += n;
+    bool corretto = s.coppie == 1000 && s.capacita == 2048 && somma == 1000
+                    && s.sondaggioMassimo == dictionary.sondaggioMassimo()
+                    && (!s.contatori || (s.ricercheRiuscite == 1000 && s.ricercheFallite == 1000
+                                         && s.ridimensionamenti == 8));
+
+    if (corretto) {
+        cout << "Statistiche ClosedHash: ";
+        s.scriviJson(cout);
+        cout << endl;
+    } else {
+        cout << "ERRORE: Statistiche ClosedHash errate." << endl;
+        s.scriviTesto(cout);
+    }
+}
+
+void testSnapshot() {
+    // Snapshot su file di un ClosedHash, interrogato direttamente dalla mappatura
+    ClosedHash<string, string> nomi;
+    ClosedHash<int, double> numeri;
+    for (int i = 0; i < 2000; i++) {
+        nomi.try_emplace("chiave" + to_string(i), "valore" + to_string(i));
+        numeri.try_emplace(i, i * 0.5);
+    }
+    MappedHash<string, string>::scrivi(nomi, "snapshot_nomi.bin");
+    MappedHash<int, double>::scrivi(numeri, "snapshot_numeri.bin");
+
+    bool corretto = true;
+    {
+        MappedHash<string, string> vistaNomi("snapshot_nomi.bin");
+        MappedHash<int, double> vistaNumeri("snapshot_numeri.bin");
+        for (int i = 0; i < 2000; i++) {
+            if (vistaNomi.recupera("chiave" + to_string(i)) != "valore" + to_string(i)
+                || vistaNumeri.recupera(i) != i * 0.5)
+                corretto = false;
+        }
+        string_view valore;
+        if (vistaNomi.lunghezza() != 2000 || vistaNomi.appartiene("chiave2000")
+            || vistaNumeri.appartiene(-1) || !vistaNomi.tryGet("chiave7", valore) || valore != "valore7")
+            corretto = false;
+    }
+
+    if (corretto) {
+        cout << "Snapshot mappato in memoria corretto." << endl;
+    } else {
+        cout << "ERRORE: Snapshot mappato in memoria errato." << endl;
+    }
+
+    try {
+        MappedHash<int, int> tipiErrati("snapshot_nomi.bin");
+        cout << "ERRORE: Snapshot aperto con tipi errati." << endl;
+    } catch (runtime_error& e) {
+        cout << "Snapshot con tipi errati rifiutato: " << e.what() << endl;
+    }
+    remove("snapshot_nomi.bin");
+    remove("snapshot_numeri.bin");
+}
+
+void testFrozen() {
+    // Dizionario immutabile con funzione hash perfetta minima
+    ClosedHash<int, string> dictionary;
+    for (int i = 0; i < 5000; i++)
+        dictionary.try_emplace(i * 3, to_string(i));
+    FrozenHash<int, string> frozen(dictionary);
+
+    bool corretto = frozen.lunghezza() == 5000 && frozen.keys().lunghezza() == 5000;
+    for (int i = 0; i < 5000; i++) {
+        if (frozen.recupera(i * 3) != to_string(i) || frozen.appartiene(i * 3 + 1))
+            corretto = false;
+    }
+
+    if (corretto) {
+        cout << "FrozenHash costruito da ClosedHash corretto." << endl;
+    } else {
+        cout << "ERRORE: FrozenHash costruito da ClosedHash errato." << endl;
+    }
+
+    VectorList<Couple<string, int>> lista;
+    lista.inserisciCoda(Couple<string, int>("uno", 1));
+    lista.inserisciCoda(Couple<string, int>("due", 2));
+    lista.inserisciCoda(Couple<string, int>("uno", 3));
+    try {
+        FrozenHash<string, int> duplicati(lista);
+        cout << "ERRORE: FrozenHash accetta chiavi duplicate." << endl;
+    } catch (invalid_argument& e) {
+        cout << "FrozenHash rifiuta le chiavi duplicate: " << e.what() << endl;
+    }
+}
+
+void testSmall() {
+    // Fino a 4 coppie interne, poi passaggio trasparente a ClosedHash
+    SmallHash<string, int> dictionary;
+    bool corretto = dictionary.inLinea() && dictionary.dizionarioVuoto();
+    for (int i = 0; i < 4; i++)
+        dictionary.try_emplace("chiave" + to_string(i), i);
+    corretto = corretto && dictionary.inLinea() && dictionary.lunghezza() == 4;
+    dictionary.cancella("chiave1");
+    dictionary.insert_or_assign("chiave3", 30);
+    corretto = corretto && !dictionary.appartiene("chiave1") && dictionary.recupera("chiave3") == 30;
+
+    SmallHash<string, int> copia(dictionary);
+    for (int i = 4; i < 100; i++)
+        dictionary.inserisci(Couple<string, int>("chiave" + to_string(i), i));
+    corretto = corretto && !dictionary.inLinea() && dictionary.lunghezza() == 99
+               && dictionary.recupera("chiave0") == 0 && dictionary.recupera("chiave3") == 30
+               && dictionary.recupera("chiave99") == 99 && copia.inLinea() && copia.lunghezza() == 3;
+
+    dictionary.clear();
+    corretto = corretto && dictionary.inLinea() && dictionary.dizionarioVuoto();
+
+    if (corretto) {
+        cout << "SmallHash corretto (" << sizeof(SmallHash<int, int>) << " byte per SmallHash<int, int>)." << endl;
+    } else {
+        cout << "ERRORE: SmallHash errato." << endl;
+    }
+}
+
+void testArena() {
+    // Tabelle prelevate da un'arena condivisa e rilasciate tutte insieme
+    Arena arena;
+    typedef ClosedHash<int, int, Hash<int>, AllocatoreArena<Couple<int, int>>> HashArena;
+    AllocatoreArena<Couple<int, int>> allocatore(arena);
+    bool corretto = true;
+    {
+        HashArena dictionary(8, Sondaggio::LINEARE, Ridimensionamento::COMPLETO, allocatore);
+        for (int i = 0; i < 100000; i++)
+            dictionary.try_emplace(i, i * 2);
+        HashArena copia(dictionary);
+        HashArena assegnata(8, Sondaggio::LINEARE, Ridimensionamento::COMPLETO, allocatore);
+        assegnata = copia;
+        for (int i = 0; i < 100000; i++) {
+            if (copia.recupera(i) != i * 2 || assegnata.recupera(i) != i * 2)
+                corretto = false;
+        }
+        corretto = corretto && copia.getAllocatore() == allocatore && arena.occupati() > 0;
+        dictionary.clear();
+        corretto = corretto && dictionary.dizionarioVuoto() && copia.lunghezza() == 100000;
+    }
+    size_t occupati = arena.occupati();
+    arena.svuota();
+
+    if (corretto && arena.occupati() == 0) {
+        cout << "ClosedHash con AllocatoreArena corretto (" << occupati / 1024 << " KiB di arena)." << endl;
+    } else {
+        cout << "ERRORE: ClosedHash con AllocatoreArena errato." << endl;
+    }
+}
+
+void testCow() {
+    // Le istantanee non vedono le modifiche successive alla propria creazione
+    CowHash<int, string> dictionary;
+    for (int i = 0; i < 1000; i++)
+        dictionary.inserisci(Couple<int, string>(i, to_string(i)));
+    CowHash<int, string>::Istantanea istantanea = dictionary.istantanea();
+    CowHash<int, string> copia(dictionary);
+
+    for (int i = 0; i < 500; i++)
+        dictionary.cancella(i);
+    for (int i = 500; i < 1000; i++)
+        dictionary.aggiorna(i, "nuovo");
+    for (int i = 1000; i < 5000; i++)
+        dictionary.inserisci(Couple<int, string>(i, to_string(i)));
+
+    bool corretto = istantanea.lunghezza() == 1000 && copia.lunghezza() == 1000
+                    && dictionary.lunghezza() == 4500 && istantanea.keys().lunghezza() == 1000;
+    for (int i = 0; i < 1000; i++) {
+        if (istantanea.recupera(i) != to_string(i) || copia.recupera(i) != to_string(i))
+            corretto = false;
+    }
+    corretto = corretto && !dictionary.appartiene(0) && dictionary.recupera(999) == "nuovo"
+               && !istantanea.appartiene(4000) && dictionary.recupera(4000) == "4000";
+
+    if (corretto) {
+        cout << "Istantanee di CowHash corrette." << endl;
+    } else {
+        cout << "ERRORE: istantanee di CowHash errate." << endl;
+    }
+
+    // Lettori su istantanee successive mentre un thread modifica il dizionario
+    CowHash<int, int> contatori;
+    for (int i = 0; i < 256; i++)
+        contatori.inserisci(Couple<int, int>(i, 0));
+    vector<thread> lettori;
+    atomic<bool> coerente(true);
+    for (int giro = 1; giro <= 8; giro++) {
+        for (int i = 0; i < 256; i++)
+            contatori.aggiorna(i, giro);
+        contatori.inserisci(Couple<int, int>(1000 + giro, giro));
+        CowHash<int, int>::Istantanea istantanea = contatori.istantanea();
+        lettori.emplace_back([istantanea, giro, &coerente]() {
+            for (int ripeti = 0; ripeti < 50; ripeti++) {
+                for (int i = 0; i < 256; i++) {
+                    if (istantanea.recupera(i) != giro)
+                        coerente = false;
+                }
+                if (istantanea.lunghezza() != 256 + giro)
+                    coerente = false;
+            }
+        });
+    }
+    for (thread& t : lettori)
+        t.join();
+
+    if (coerente) {
+        cout << "Le istantanee lette da altri thread restano coerenti." << endl;
+    } else {
+        cout << "ERRORE: un'istantanea letta da un altro thread e' cambiata." << endl;
+    }
+}
+
+void testBTree() {
+    // Inserimento in ordine sparso, visita ordinata e ricerche per intervallo
+    const int n = 200000;
+    BTree<int, int> albero;
+    for (int i = 0; i < n; i++) {
+        int k = (int)((i * 7919LL) % n);
+        albero.try_emplace(k, k * 2);
+    }
+    bool corretto = albero.lunghezza() == n && albero.altezza() <= 4;
+    int atteso = 0;
+    for (const Couple<int, int>& c : albero) {
+        if (c.getKey() != atteso || c.getElement() != atteso * 2)
+            corretto = false;
+        atteso++;
+    }
+    corretto = corretto && atteso == n && albero.lower_bound(500)->getKey() == 500
+               && albero.upper_bound(500)->getKey() == 501 && albero.lower_bound(n) == albero.end();
+    int nellIntervallo = 0;
+    for (const Couple<int, int>& c : albero.intervallo(1000, 2000)) {
+        if (c.getKey() < 1000 || c.getKey() >= 2000)
+            corretto = false;
+        nellIntervallo++;
+    }
+    corretto = corretto && nellIntervallo == 1000;
+
+    if (corretto) {
+        cout << "BTree: visita ordinata e intervalli corretti (altezza " << albero.altezza() << ")." << endl;
+    } else {
+        cout << "ERRORE: visita ordinata o intervalli di BTree errati." << endl;
+    }
+
+    // Cancellazioni che svuotano intere foglie e nodi interni
+    for (int i = 0; i < n; i++) {
+        if (i % 3 != 0)
+            albero.cancella(i);
+    }
+    BTree<int, int> copia(albero);
+    corretto = albero.lunghezza() == (n + 2) / 3 && copia == albero;
+    atteso = 0;
+    for (const Couple<int, int>& c : copia) {
+        if (c.getKey() != atteso)
+            corretto = false;
+        atteso += 3;
+    }
+    for (int i = 0; i < n; i += 3)
+        albero.cancella(i);
+    corretto = corretto && albero.dizionarioVuoto() && albero.altezza() == 0
+               && albero.begin() == albero.end() && copia.lunghezza() == (n + 2) / 3;
+
+    if (corretto) {
+        cout << "BTree: cancellazioni e copia corrette." << endl;
+    } else {
+        cout << "ERRORE: cancellazioni o copia di BTree errate." << endl;
+    }
+
+    // Ricerca per prefisso su chiavi stringa
+    BTree<string, int> nomi;
+    const char* parole[] = {"albero", "alba", "alce", "al", "b", "alb", "alzare", "ala"};
+    for (int i = 0; i < 8; i++)
+        nomi.try_emplace(parole[i], i);
+    string trovate;
+    for (const Couple<string, int>& c : nomi.prefisso("alb"))
+        trovate += c.getKey() + " ";
+
+    if (trovate == "alb alba albero ") {
+        cout << "BTree: ricerca per prefisso corretta." << endl;
+    } else {
+        cout << "ERRORE: ricerca per prefisso di BTree errata: " << trovate << endl;
+    }
+}
+
+void testArt() {
+    // Chiavi simili a URL, con lunghi prefissi comuni
+    const int n = 100000;
+    ArtTree<int> albero;
+    size_t byteChiavi = 0;
+    for (int i = 0; i < n; i++) {
+        string url = "https://www.esempio.it/catalogo/reparto" + to_string(i % 40) + "/articolo/" + to_string(i);
+        byteChiavi += url.size();
+        albero.try_emplace(url, i);
+    }
+    bool corretto = albero.lunghezza() == n;
+    for (int i = 0; i < n && corretto; i++) {
+        const int* e = albero.find("https://www.esempio.it/catalogo/reparto" + to_string(i % 40) + "/articolo/" + to_string(i));
+        corretto = e != nullptr && *e == i;
+    }
+    corretto = corretto && !albero.appartiene("https://www.esempio.it/catalogo/reparto1")
+               && !albero.appartiene("https://www.esempio.it/catalogo/reparto1/articolo/10000000");
+
+    if (corretto) {
+        cout << "ArtTree: " << n << " chiavi in " << albero.memoria() << " byte (le sole chiavi occupano "
+             << byteChiavi << " byte)." << endl;
+    } else {
+        cout << "ERRORE: ricerche in ArtTree errate." << endl;
+    }
+
+    // Visita ordinata e per prefisso, anche con chiavi prefisso di altre chiavi
+    ArtTree<int> nomi;
+    const char* parole[] = {"albero", "alba", "alce", "al", "b", "alb", "alzare", "ala", ""};
+    for (int i = 0; i < 9; i++)
+        nomi.try_emplace(parole[i], i);
+    string tutte, trovate;
+    nomi.perOgni([&tutte](const string& k, const int&) {tutte += "[" + k + "]";});
+    nomi.perOgniConPrefisso("alb", [&trovate](const string& k, const int&) {trovate += k + " ";});
+    int conPrefissoA = 0;
+    nomi.perOgniConPrefisso("a", [&conPrefissoA](const string&, const int&) {conPrefissoA++;});
+
+    if (tutte == "[][al][ala][alb][alba][albero][alce][alzare][b]" && trovate == "alb alba albero "
+        && conPrefissoA == 7) {
+        cout << "ArtTree: visita ordinata e per prefisso corretta." << endl;
+    } else {
+        cout << "ERRORE: visita di ArtTree errata: " << tutte << " / " << trovate << endl;
+    }
+
+    // Cancellazioni che riducono e fondono i nodi
+    ArtTree<int> copia(albero);
+    for (int i = 0; i < n; i++) {
+        if (i % 5 != 0)
+            albero.cancella("https://www.esempio.it/catalogo/reparto" + to_string(i % 40) + "/articolo/" + to_string(i));
+    }
+    corretto = albero.lunghezza() == n / 5 && copia.lunghezza() == n && copia != albero;
+    for (int i = 0; i < n && corretto; i++) {
+        string url = "https://www.esempio.it/catalogo/reparto" + to_string(i % 40) + "/articolo/" + to_string(i);
+        corretto = albero.appartiene(url) == (i % 5 == 0) && copia.appartiene(url);
+    }
+    size_t ridotta = albero.memoria();
+    for (int i = 0; i < n; i += 5)
+        albero.cancella("https://www.esempio.it/catalogo/reparto" + to_string(i % 40) + "/articolo/" + to_string(i));
+    corretto = corretto && albero.dizionarioVuoto() && albero.memoria() == 0 && ridotta < copia.memoria();
+
+    if (corretto) {
+        cout << "ArtTree: cancellazioni e copia corrette." << endl;
+    } else {
+        cout << "ERRORE: cancellazioni o copia di ArtTree errate." << endl;
+    }
+}
+
+void testConcorrente() {
+    ConcurrentHash<int, string> dictionary(16);
+
+    // Otto thread inseriscono, leggono e cancellano chiavi disgiunte
+    vector<thread> threads;
+    bool errore[8] = {false};
+    for (int t = 0; t < 8; t++) {
+        threads.push_back(thread([&dictionary, &errore, t]() {
+            for (int i = 0; i < 1000; i++)
+                dictionary.try_emplace(t * 1000 + i, to_string(i));
+            for (int i = 0; i < 1000; i++) {
+                string value;
+                if (!dictionary.tryGet(t * 1000 + i, value) || value != to_string(i))
+                    errore[t] = true;
+            }
+            for (int i = 0; i < 1000; i += 2)
+                dictionary.cancella(t * 1000 + i);
+        }));
+    }
+    for (thread& th : threads)
+        th.join();
+
+    bool corretto = dictionary.lunghezza() == 4000 && dictionary.keys().lunghezza() == 4000;
+    for (int t = 0; t < 8; t++) {
+        if (errore[t] || dictionary.appartiene(t * 1000) || dictionary.recupera(t * 1000 + 1) != "1")
+            corretto = false;
+    }
+
+    if (corretto) {
+        cout << "ConcurrentHash: inserimenti e cancellazioni da 8 thread corretti." << endl;
+    } else {
+        cout << "ERRORE: ConcurrentHash: inserimenti o cancellazioni da 8 thread errati." << endl;
+    }
+}
+
+void testLockFree() {
+    LockFreeHash<int, int> dictionary;
+    for (int i = 0; i < 1000; i++)
+        dictionary.inserisci(Couple<int, int>(i, i));
+
+    // Quattro lettori leggono le chiavi 0..999 mentre uno scrittore inserisce e
+    // cancella altre chiavi, causando ridimensionamenti, e aggiorna quelle lette
+    atomic<bool> fine(false);
+    atomic<bool> errore(false);
+    vector<thread> lettori;
+    for (int t = 0; t < 4; t++) {
+        lettori.push_back(thread([&dictionary, &fine, &errore, t]() {
+            int k = t;
+            while (!fine.load()) {
+                int value;
+                if (!dictionary.tryGet(k, value) || value % 1000 != k)
+                    errore = true;
+                k = (k + 7) % 1000;
+            }
+        }));
+    }
+    for (int i = 0; i < 50000; i++) {
+        dictionary.insert_or_assign(1000 + i, i);
+        if (i >= 1000)
+            dictionary.cancella(i);
+        dictionary.aggiorna(i % 1000, i % 1000 + 1000 * (i % 3));
+    }
+    fine = true;
+    for (thread& th : lettori)
+        th.join();
+
+    if (!errore && dictionary.lunghezza() == 2000 && dictionary.keys().lunghezza() == 2000) {
+        cout << "LockFreeHash: letture senza lock durante scritture e ridimensionamenti corrette." << endl;
+    } else {
+        cout << "ERRORE: LockFreeHash: letture senza lock errate." << endl;
+    }
+}
+
+/**
+ * @brief Verifica il contratto dell'interfaccia Dictionary su una qualunque implementazione.
+ * @param dictionary dizionario vuoto da verificare.
+ * @param nome nome dell'implementazione, stampato nei messaggi.
+ */
+void testDizionario(Dictionary<int, string>& dictionary, const string& nome) {
+    // Inserimento di 1000 coppie
+    for (int i = 0; i < 1000; i++) {
+        Couple<int, string> couple(i, to_string(i));
+        dictionary.inserisci(couple);
+    }
+
+    bool duplicato = false;
+    try {
+        Couple<int, string> couple(10, "Ten");
+        dictionary.inserisci(couple);
+    } catch (std::runtime_error&) {
+        duplicato = true;
+    }
+
+    if (dictionary.lunghezza() == 1000 && duplicato) {
+        cout << nome << ": inserimento di 1000 coppie corretto, duplicato rifiutato." << endl;
+    } else {
+        cout << "ERRORE: " << nome << ": inserimento di 1000 coppie errato." << endl;
+    }
+
+    // Rimozione delle chiavi multiple di 3 e aggiornamento delle chiavi pari
+    for (int i = 0; i < 1000; i += 3)
+        dictionary.cancella(i);
+    for (int i = 0; i < 1000; i += 2) {
+        if (dictionary.appartiene(i))
+            dictionary.aggiorna(i, "pari");
+    }
+
+    bool corretto = dictionary.lunghezza() == 666;
+    for (int i = 0; i < 1000; i++) {
+        if (dictionary.appartiene(i) != (i % 3 != 0))
+            corretto = false;
+        else if (i % 3 != 0 && dictionary.recupera(i) != (i % 2 == 0 ? "pari" : to_string(i)))
+            corretto = false;
+    }
+
+    bool mancante = false;
+    try {
+        dictionary.recupera(3);
+    } catch (std::out_of_range&) {
+        mancante = true;
+    }
+
+    if (corretto && mancante) {
+        cout << nome << ": cancellazioni, aggiornamenti e ricerche corretti." << endl;
+    } else {
+        cout << "ERRORE: " << nome << ": cancellazioni, aggiornamenti o ricerche errati." << endl;
+    }
+
+    VectorList<int> keys = dictionary.keys();
+    VectorList<string> values = dictionary.values();
+    if (keys.lunghezza() == 666 && values.lunghezza() == 666) {
+        cout << nome << ": keys() e values() restituiscono tutte le coppie." << endl;
+    } else {
+        cout << "ERRORE: " << nome << ": keys() o values() errati." << endl;
+    }
+
+    dictionary.clear();
+    if (dictionary.dizionarioVuoto() && !dictionary.appartiene(1)) {
+        cout << nome << ": il dizionario e' stato correttamente ripulito." << endl;
+    } else {
+        cout << "ERRORE: " << nome << ": il dizionario non e' stato correttamente ripulito." << endl;
+    }
+}
+
 int main() {
     testClosedHash();
+    testClosedHashRobinHood();
+    testHash();
+    testEmplace();
+    testCaricamento();
+    testIncrementale();
+    testIteratori();
+    testTrasparente();
+    testRecuperaMolti();
+    testStatistiche();
+    testSnapshot();
+    testFrozen();
+    testSmall();
+    testArena();
+    testCow();
+    testBTree();
+    testArt();
+    testConcorrente();
+    testLockFree();
+
+    ClosedHash<int, string> closedHash;
+    testDizionario(closedHash, "ClosedHash");
+    SwissHash<int, string> swissHash;
+    testDizionario(swissHash, "SwissHash");
+    OpenHash<int, string> openHash;
+    testDizionario(openHash, "OpenHash");
+    ConcurrentHash<int, string> concurrentHash;
+    testDizionario(concurrentHash, "ConcurrentHash");
+    LockFreeHash<int, string> lockFreeHash;
+    testDizionario(lockFreeHash, "LockFreeHash");
+    SmallHash<int, string> smallHash;
+    testDizionario(smallHash, "SmallHash");
+    CowHash<int, string> cowHash;
+    testDizionario(cowHash, "CowHash");
+    BTree<int, string> bTree;
+    testDizionario(bTree, "BTree");
     return 0;
 }
\ No newline at end of file
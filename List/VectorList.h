@@ -5,7 +5,7 @@
 #include <ostream>
 #include <stdexcept>
 
-#include "Linearlist.h"
+#include "LinearList.h"
 using namespace std;
 
 /**